@@ -0,0 +1,70 @@
+#include "Call.h"
+#include "Arena.h"
+#include "AllocationStats.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Heap allocations and time per request, with and without the arena.
+ *
+ * Usage: arena_bench [N] [requests]
+ * Build with -DLOOKBACK_ALLOC_STATS: the counting allocator is off by default.
+ * A request prices a call with its Delta, Theta, Rho and Vega, like one Excel
+ * call. With the arena, every request after the first should show zero heap
+ * allocations; without it, each buffer and bumped run goes through the heap.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double request(int N)
+    {
+        ensiie::ArenaPtr<ensiie::Call> option = ensiie::make_arena<ensiie::Call>(0.0, 1.0, 100.0, 0.05, 0.2, N, 1.0, 10, 42);
+        return option->price() + option->delta() + option->theta() + option->rho() + option->vega();
+    }
+
+    void run(const std::string& name, int N, int requests, bool arena)
+    {
+        for (int k = 0; k < requests; ++k)
+        {
+            const ensiie::AllocationStats before = ensiie::allocation_stats();
+            const auto t0 = Clock::now();
+
+            const double value = arena
+                ? ensiie::in_thread_arena([&]() { return request(N); })
+                : request(N);
+
+            const auto t1 = Clock::now();
+            const ensiie::AllocationStats used = ensiie::allocation_stats() - before;
+
+            std::cout << name << " request " << k
+                << ": allocations " << used.allocations
+                << ", bytes " << used.bytes
+                << ", time " << std::chrono::duration<double>(t1 - t0).count() << "s"
+                << " (checksum " << value << ")\n";
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int N = (argc > 1) ? std::stoi(argv[1]) : 20000;
+    const int requests = (argc > 2) ? std::stoi(argv[2]) : 4;
+
+    if (!ensiie::allocation_counting_enabled()) {
+        std::cerr << "arena_bench: build with -DLOOKBACK_ALLOC_STATS to count the allocations\n";
+        return 1;
+    }
+
+    std::cout << std::setprecision(6) << "N = " << N << "\n";
+    run("heap", N, requests, false);
+    run("arena", N, requests, true);
+
+    const ensiie::Arena& arena = ensiie::thread_arena();
+    std::cout << "arena capacity " << arena.capacity() << " bytes in "
+        << arena.chunk_allocations() << " chunk allocations\n";
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include "BatchEngine.h"
+#include "Call.h"
+#include "put.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+
+/**
+ * @brief Throughput of the batched engine on a book of small intraday trades.
+ *
+ * Usage: batch_bench [trades] [N]
+ * Prices a random book (1 to 20 days to maturity, N paths each) trade by trade
+ * with Call/Put objects and then with one BatchEngine, prints trades/sec of
+ * both and checks that every Price, Delta and Vega is bit-identical.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double seconds(Clock::time_point t0)
+    {
+        return std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int count = (argc > 1) ? std::stoi(argv[1]) : 10000;
+    const int N = (argc > 2) ? std::stoi(argv[2]) : 256;
+
+    std::mt19937 gen(2024);
+    std::uniform_int_distribution<int> days(1, 20);
+    std::uniform_real_distribution<double> spot(80.0, 120.0), rate(0.0, 0.05), vol(0.1, 0.4);
+
+    std::vector<ensiie::BatchTrade> book;
+    for (int j = 0; j < count; ++j)
+    {
+        const double T = (days(gen) + 0.5) / 252.0;
+        book.push_back(ensiie::BatchTrade{ (j % 2) ? ensiie::OptionType::Put : ensiie::OptionType::Call,
+            0.0, T, spot(gen), rate(gen), vol(gen), N, static_cast<unsigned long>(j) });
+    }
+
+    // Trade by trade, as the pricer does for one Excel call
+    std::vector<ensiie::BatchResult> single(count);
+    auto t0 = Clock::now();
+    for (int j = 0; j < count; ++j)
+    {
+        const ensiie::BatchTrade& d = book[j];
+        std::unique_ptr<ensiie::Pricing> option;
+        if (d.type == ensiie::OptionType::Call)
+            option = std::make_unique<ensiie::Call>(d.t, d.T, d.S0, d.r, d.sigma, d.N, 1.0, 10, d.seed);
+        else
+            option = std::make_unique<ensiie::Put>(d.t, d.T, d.S0, d.r, d.sigma, d.N, 1.0, 10, d.seed);
+
+        single[j].price = option->price();
+        single[j].delta = option->delta();
+        single[j].vega = option->vega();
+        single[j].price_stderr = option->get_discount() * option->payoff_stderr();
+    }
+    const double singleSeconds = seconds(t0);
+
+    t0 = Clock::now();
+    const ensiie::BatchEngine engine(book);
+    const std::vector<ensiie::BatchResult> batched = engine.run();
+    const double batchSeconds = seconds(t0);
+
+    int mismatches = 0;
+    for (int j = 0; j < count; ++j)
+    {
+        if (single[j].price != batched[j].price || single[j].delta != batched[j].delta
+            || single[j].vega != batched[j].vega)
+            ++mismatches;
+    }
+
+    std::cout << std::setprecision(6) << count << " trades, N = " << N << "\n"
+        << "trade by trade: " << singleSeconds << "s, " << count / singleSeconds << " trades/sec\n"
+        << "batched:        " << batchSeconds << "s, " << count / batchSeconds << " trades/sec ("
+        << engine.get_chunk_count() << " chunks of up to " << ensiie::BatchEngine::lane_capacity << " lanes)\n"
+        << "speedup " << singleSeconds / batchSeconds << "x, " << mismatches << " trades differ\n";
+    return mismatches == 0 ? 0 : 1;
+}
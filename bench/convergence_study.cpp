@@ -0,0 +1,187 @@
+#include "Call.h"
+#include "put.h"
+#include "Arena.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Accuracy per CPU second of estimator configurations.
+ *
+ * Usage: convergence_study [call|put] [seeds] [tolerance] [contract_fixings] [reference]
+ * For a fresh at-the-money option (T = 1, r = 5%, sigma = 20%), sweeps N,
+ * the number of monitoring steps a year and the sampling scheme. Each
+ * configuration is priced with seeds independent seeds; against the
+ * reference price of the contract (by default the closed form for
+ * contract_fixings fixings a year, 252 by default, 0 for continuous), it
+ * reports the mean price, bias, RMSE, mean payoff_stderr() of one run, CPU
+ * time of one run and the efficiencies 1 / (variance x time) and
+ * 1 / (MSE x time), the second one counting the monitoring bias. The last
+ * line is the cheapest configuration whose RMSE meets the tolerance.
+ */
+
+namespace
+{
+    const double S0 = 100.0, r = 0.05, sigma = 0.2, T = 1.0;
+
+    double normal_cdf(double x)
+    {
+        return 0.5 * std::erfc(-x / std::sqrt(2.0));
+    }
+
+    /** @brief Continuously monitored floating-strike lookback, fresh trade (Goldman, Sosin and Gatto). */
+    double closed_form(bool call)
+    {
+        const double a1 = (r + 0.5 * sigma * sigma) * T / (sigma * std::sqrt(T));
+        const double a2 = a1 - sigma * std::sqrt(T);
+        const double a3 = (-r + 0.5 * sigma * sigma) * T / (sigma * std::sqrt(T));
+        const double k = sigma * sigma / (2.0 * r);
+        const double discount = std::exp(-r * T);
+
+        if (call)
+            return S0 * normal_cdf(a1) - S0 * k * normal_cdf(-a1)
+                - S0 * discount * (normal_cdf(a2) - k * normal_cdf(-a3));
+
+        return -S0 * normal_cdf(-a1) + S0 * k * normal_cdf(a1)
+            + S0 * discount * (normal_cdf(-a2) - k * normal_cdf(a3));
+    }
+
+    /**
+     * @brief Closed form of a contract with fixingsPerYear fixings a year (0: continuous),
+     * from the Broadie, Glasserman and Kou shift of the continuous extreme by
+     * exp(+-0.5826 sigma sqrt(dt)).
+     */
+    double reference_price(bool call, double fixingsPerYear)
+    {
+        const double continuous = closed_form(call);
+        if (fixingsPerYear <= 0.0)
+            return continuous;
+
+        // Discounted expectations: e^{-rT} E[S_T] = S0, so e^{-rT} E[min] = S0 - C and e^{-rT} E[max] = P + S0
+        const double shift = std::exp(0.5826 * sigma * std::sqrt(1.0 / fixingsPerYear));
+        return call ? S0 - shift * (S0 - continuous) : (continuous + S0) / shift - S0;
+    }
+
+    /** @brief One estimator configuration of the sweep. */
+    struct Config
+    {
+        int N;                       ///< Paths per run
+        int stepsPerYear;            ///< Monitoring steps a year (252: daily grid)
+        ensiie::Sampling sampling;   ///< Sampling scheme
+    };
+
+    /** @brief Statistics of one configuration over the seeds. */
+    struct Point
+    {
+        Config config;
+        double mean;         ///< Mean price over the seeds
+        double bias;         ///< mean - reference
+        double rmse;         ///< Root mean squared error against the reference
+        double stderr_run;   ///< Mean price standard error of one run (payoff_stderr x discount)
+        double cpu;          ///< Mean CPU seconds of one run (simulation and price)
+        double efficiency;   ///< 1 / (variance x time), variance from the spread over the seeds
+        double mse_efficiency; ///< 1 / (MSE x time)
+    };
+
+    const char* sampling_name(ensiie::Sampling s)
+    {
+        return (s == ensiie::Sampling::Stratified) ? "stratified" : "antithetic";
+    }
+
+    template <class Option>
+    Point study(const Config& config, int seeds, double reference)
+    {
+        ensiie::SimulationSettings settings;
+        settings.sampling = config.sampling;
+        if (config.stepsPerYear != 252)
+            settings.fixing_dates = ensiie::MonteCarlo::regular_fixings(0.0, T, config.stepsPerYear);
+
+        double sum = 0.0, sumSq = 0.0, sumErrSq = 0.0, sumStderr = 0.0, cpu = 0.0;
+        for (int s = 0; s < seeds; ++s)
+        {
+            double price = 0.0, stderrRun = 0.0;
+            ensiie::in_thread_arena([&]()
+                {
+                    const std::clock_t c0 = std::clock();
+                    const Option option(0.0, T, S0, r, sigma, config.N, 1.0, 1, 1000 + s, settings);
+                    price = option.price();
+                    const std::clock_t c1 = std::clock();
+
+                    cpu += static_cast<double>(c1 - c0) / CLOCKS_PER_SEC;
+                    stderrRun = option.get_discount() * option.payoff_stderr();
+                });
+
+            sum += price;
+            sumSq += price * price;
+            sumErrSq += (price - reference) * (price - reference);
+            sumStderr += stderrRun;
+        }
+
+        const double n = static_cast<double>(seeds);
+        const double mean = sum / n;
+        const double variance = std::max(0.0, (sumSq - n * mean * mean) / (n - 1.0));
+        const double mse = sumErrSq / n;
+        const double time = cpu / n;
+
+        return Point{ config, mean, mean - reference, std::sqrt(mse), sumStderr / n, time,
+            1.0 / (variance * time), 1.0 / (mse * time) };
+    }
+
+    template <class Option>
+    std::vector<Point> sweep(int seeds, double reference)
+    {
+        const int Ns[] = { 1024, 4096, 16384 };
+        const int steps[] = { 12, 52, 252 };
+        const ensiie::Sampling samplings[] = { ensiie::Sampling::Antithetic, ensiie::Sampling::Stratified };
+
+        std::cout << "N;StepsPerYear;Sampling;MeanPrice;Bias;RMSE;StdErr;CpuSeconds;Efficiency;MseEfficiency\n";
+
+        std::vector<Point> points;
+        for (int F : steps)
+            for (ensiie::Sampling sampling : samplings)
+                for (int N : Ns)
+                {
+                    const Point p = study<Option>(Config{ N, F, sampling }, seeds, reference);
+                    points.push_back(p);
+
+                    std::cout << N << ";" << F << ";" << sampling_name(sampling) << ";"
+                        << p.mean << ";" << p.bias << ";" << p.rmse << ";" << p.stderr_run << ";"
+                        << p.cpu << ";" << p.efficiency << ";" << p.mse_efficiency << "\n" << std::flush;
+                }
+        return points;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const bool call = (argc > 1) ? std::string(argv[1]) != "put" : true;
+    const int seeds = (argc > 2) ? std::stoi(argv[2]) : 16;
+    const double tolerance = (argc > 3) ? std::stod(argv[3]) : 0.1;
+    const double contractFixings = (argc > 4) ? std::stod(argv[4]) : 252.0;
+    const double reference = (argc > 5) ? std::stod(argv[5]) : reference_price(call, contractFixings);
+
+    std::cout << std::setprecision(6) << (call ? "call" : "put") << ", seeds = " << seeds
+        << ", reference = " << reference << ", tolerance = " << tolerance << "\n";
+
+    const std::vector<Point> points = call
+        ? sweep<ensiie::Call>(seeds, reference)
+        : sweep<ensiie::Put>(seeds, reference);
+
+    // Cheapest configuration meeting the tolerance
+    const Point* best = nullptr;
+    for (const Point& p : points)
+        if (p.rmse <= tolerance && (!best || p.cpu < best->cpu))
+            best = &p;
+
+    if (best)
+        std::cout << "cheapest within tolerance: N = " << best->config.N
+            << ", " << best->config.stepsPerYear << " steps a year, " << sampling_name(best->config.sampling)
+            << " (RMSE " << best->rmse << ", " << best->cpu << " CPU s)\n";
+    else
+        std::cout << "no configuration within tolerance\n";
+    return 0;
+}
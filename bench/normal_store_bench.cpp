@@ -0,0 +1,58 @@
+#include "Call.h"
+#include "Arena.h"
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Pricing time without normal store, with a cold store and with a warm one.
+ *
+ * Usage: normal_store_bench [N] [directory]
+ * The cold run draws the stream and writes the store; warm runs map it and
+ * skip the random number generation. The three prices must be identical.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double run(const std::string& name, int N, const ensiie::SimulationSettings& settings)
+    {
+        const auto t0 = Clock::now();
+        const double price = ensiie::in_thread_arena([&]()
+            {
+                ensiie::Call option(0.0, 1.0, 100.0, 0.05, 0.2, N, 1.0, 10, 42, settings);
+                return option.price();
+            });
+        const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        std::cout << name << ": " << seconds << "s (price " << price << ")\n";
+        return price;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int N = (argc > 1) ? std::stoi(argv[1]) : 100000;
+    const std::string dir = (argc > 2) ? argv[2] : ".";
+
+    ensiie::SimulationSettings plain;
+    ensiie::SimulationSettings stored;
+    stored.normal_store = dir;
+
+    // Start cold: remove the store of this run, if any
+    const int Nt = 252;
+    const ensiie::NormalStoreKey key{ ensiie::MonteCarlo::normal_generator_id, 42, N, Nt, 1.0 / 252.0 };
+    std::remove(ensiie::NormalStore::file_name(dir, key).c_str());
+
+    std::cout << std::setprecision(10) << "N = " << N << "\n";
+    const double p0 = run("generator", N, plain);
+    const double p1 = run("cold store", N, stored);
+    const double p2 = run("warm store", N, stored);
+    const double p3 = run("warm store", N, stored);
+
+    std::cout << ((p0 == p1 && p1 == p2 && p2 == p3) ? "identical prices\n" : "PRICES DIFFER\n");
+    return 0;
+}
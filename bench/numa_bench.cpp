@@ -0,0 +1,60 @@
+#include "Call.h"
+#include "Arena.h"
+#include "Numa.h"
+#include "Parallel.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Per-node throughput of independent pricings spread over the workers.
+ *
+ * Usage: numa_bench [N] [requests]
+ * Prints the NUMA topology seen by the process, then prices requests calls with
+ * parallel_for: each worker is pinned to its node and builds its paths in its
+ * own arena, so they are first touched, hence allocated, on that node. Only the
+ * prices (one double per request) are read back by the calling thread.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+}
+
+int main(int argc, char* argv[])
+{
+    const int N = (argc > 1) ? std::stoi(argv[1]) : 20000;
+    const int requests = (argc > 2) ? std::stoi(argv[2]) : 32;
+
+    const ensiie::NumaTopology& topology = ensiie::NumaTopology::host();
+    std::cout << std::setprecision(6) << "N = " << N << ", requests = " << requests
+        << ", workers = " << ensiie::worker_count() << ", nodes = " << topology.node_count() << "\n";
+    for (int n = 0; n < topology.node_count(); ++n)
+        std::cout << "node " << n << ": " << topology.cpus(n).size() << " cpus\n";
+
+    std::vector<double> prices(requests);
+    const auto t0 = Clock::now();
+    ensiie::parallel_for(requests, [&](int k)
+        {
+            prices[k] = ensiie::in_thread_arena([&]()
+                {
+                    ensiie::Call option(0.0, 1.0, 100.0, 0.05, 0.2, N, 1.0, 10, 42 + k);
+                    return option.price();
+                });
+        });
+    const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    double checksum = 0.0;
+    for (double p : prices)
+        checksum += p;
+
+    std::cout << "total: " << seconds << "s (checksum " << checksum << ")\n";
+    const std::vector<ensiie::NodeStats> stats = ensiie::node_stats();
+    for (size_t n = 0; n < stats.size(); ++n)
+        std::cout << "node " << n << ": " << stats[n].path_steps << " path steps, "
+            << stats[n].seconds << "s, "
+            << (stats[n].seconds > 0.0 ? stats[n].path_steps / stats[n].seconds : 0.0) << " steps/s\n";
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "ColumnarWriter.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Text versus binary columnar output of a large ladder.
+ *
+ * Usage: output_bench [rows]
+ * Writes rows Spot;Price;Delta lines with the Excel text formatting (fixed, 6
+ * decimals) and the same columns with ColumnarWriter, and prints the time and
+ * size of each file and the largest rounding error of the text output.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double seconds(Clock::time_point t0)
+    {
+        return std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int rows = (argc > 1) ? std::stoi(argv[1]) : 1000000;
+
+    // Smooth ladder with MC-like noise in the low digits
+    std::vector<std::vector<double>> columns(3, std::vector<double>(rows));
+    for (int i = 0; i < rows; ++i)
+    {
+        const double spot = 50.0 + 100.0 * i / rows;
+        columns[0][i] = spot;
+        columns[1][i] = 0.17 * spot + 1e-7 * std::sin(7.0 * i);
+        columns[2][i] = 0.17 + 1e-8 * std::cos(3.0 * i);
+    }
+
+    const std::string textPath = "output_bench.txt", binaryPath = "output_bench.lbk";
+
+    auto t0 = Clock::now();
+    {
+        std::ofstream out(textPath);
+        out << std::fixed << std::setprecision(6);
+        for (int i = 0; i < rows; ++i)
+            out << columns[0][i] << ";" << columns[1][i] << ";" << columns[2][i] << "\n";
+    }
+    const double textSeconds = seconds(t0);
+
+    t0 = Clock::now();
+    ensiie::ColumnarWriter writer;
+    writer.add_table("graph", { "Spot", "Price", "Delta" }, columns);
+    writer.save(binaryPath);
+    const double binarySeconds = seconds(t0);
+
+    // Precision lost by the text format
+    double maxError = 0.0;
+    {
+        std::ifstream in(textPath);
+        std::string line;
+        for (int i = 0; i < rows && std::getline(in, line); ++i)
+        {
+            const size_t a = line.find(';'), b = line.find(';', a + 1);
+            maxError = std::max(maxError, std::fabs(std::stod(line.substr(a + 1, b - a - 1)) - columns[1][i]));
+        }
+    }
+
+    std::cout << "rows " << rows << "\n"
+        << "text:   " << textSeconds << "s, " << std::ifstream(textPath, std::ios::ate | std::ios::binary).tellg()
+        << " bytes, max price rounding error " << maxError << "\n"
+        << "binary: " << binarySeconds << "s, " << writer.bytes().size() << " bytes, exact\n"
+        << "speedup " << textSeconds / binarySeconds << "x\n";
+
+    std::remove(textPath.c_str());
+    std::remove(binaryPath.c_str());
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "PayoffSet.h"
+#include "Call.h"
+#include "put.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A strip of lookback payoffs on one path set versus one run per payoff.
+ *
+ * Usage: payoff_set_bench [N] [T]
+ * Prices a strip (floating call and put, fixed-strike calls and puts, a spread
+ * and a partial-window call) with one PayoffSet on the paths of a single run,
+ * checks that its floating entries match Call and Put (same seed) on Price,
+ * Delta and Vega, and compares its time with pricing each entry by its own run.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double seconds(Clock::time_point t0)
+    {
+        return std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+
+    /** @brief Checks a strip entry against the single-payoff price; returns the number of mismatches. */
+    int check(const std::string& name, const ensiie::PayoffResult& strip, const ensiie::Pricing& single)
+    {
+        auto close = [](double a, double b) { return std::abs(a - b) <= 1e-12 * std::max(1.0, std::abs(b)); };
+
+        const double price = single.price(), delta = single.delta(), vega = single.vega();
+        const bool ok = strip.price == price && close(strip.delta, delta) && close(strip.vega, vega);
+
+        std::cout << name << ": strip " << strip.price << " / " << strip.delta << " / " << strip.vega
+            << ", single " << price << " / " << delta << " / " << vega
+            << (ok ? "  OK\n" : "  MISMATCH\n");
+        return ok ? 0 : 1;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int N = (argc > 1) ? std::stoi(argv[1]) : 20000;
+    const double T = (argc > 2) ? std::stod(argv[2]) : 1.0;
+    const double S0 = 100.0, r = 0.05, sigma = 0.2;
+    const unsigned long seed = 42;
+
+    using ensiie::PayoffKind;
+    std::vector<ensiie::PayoffSpec> specs = {
+        { PayoffKind::FloatingCall, 0.0 },
+        { PayoffKind::FloatingPut, 0.0 },
+        { PayoffKind::FixedCall, 90.0 }, { PayoffKind::FixedCall, 100.0 },
+        { PayoffKind::FixedCall, 110.0 }, { PayoffKind::FixedCall, 120.0 },
+        { PayoffKind::FixedPut, 80.0 }, { PayoffKind::FixedPut, 90.0 }, { PayoffKind::FixedPut, 100.0 },
+        { PayoffKind::Spread, 20.0 },
+        { PayoffKind::FloatingCall, 0.0, 0.0, T / 2.0 }
+    };
+    const char* names[] = { "floating call", "floating put", "fixed call 90", "fixed call 100",
+        "fixed call 110", "fixed call 120", "fixed put 80", "fixed put 90", "fixed put 100",
+        "spread 20", "call, first half" };
+    const int P = static_cast<int>(specs.size());
+
+    // One run: simulate once, evaluate the whole strip on its paths
+    auto t0 = Clock::now();
+    const ensiie::Call base(0.0, T, S0, r, sigma, N, 1.0, 10, seed);
+    const ensiie::PayoffSet strip(specs);
+    const std::vector<ensiie::PayoffResult> results = strip.evaluate(base);
+    const double stripSeconds = seconds(t0);
+
+    // Reference cost of one payoff priced alone: its own simulation, price, Delta and Vega
+    t0 = Clock::now();
+    const ensiie::Call call(0.0, T, S0, r, sigma, N, 1.0, 10, seed);
+    const double callPrice = call.price() + call.delta() + call.vega();
+    const double singleSeconds = seconds(t0);
+
+    std::cout << std::setprecision(8) << "N = " << N << ", T = " << T << ", " << P << " payoffs\n";
+    for (int p = 0; p < P; ++p)
+        std::cout << "  " << std::left << std::setw(18) << names[p] << std::right
+            << " price " << results[p].price << " +/- " << results[p].std_error
+            << ", delta " << results[p].delta << ", vega " << results[p].vega << "\n";
+
+    // Floating entries on the full window are the Call and Put of the same seed
+    const ensiie::Put put(0.0, T, S0, r, sigma, N, 1.0, 10, seed);
+    int mismatches = check("floating call vs Call", results[0], call)
+        + check("floating put vs Put", results[1], put);
+
+    std::cout << std::setprecision(6)
+        << "strip: " << stripSeconds << "s for " << P << " payoffs (one simulation)\n"
+        << "one run per payoff: " << singleSeconds << "s each, about " << P * singleSeconds << "s for the strip"
+        << " (checksum " << callPrice << ")\n"
+        << "saving " << P * singleSeconds / stripSeconds << "x, " << mismatches << " mismatches\n";
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+#include "Call.h"
+#include "put.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Compares the double and single-precision path modes.
+ *
+ * Usage: precision_bench [N] [T]
+ * Prints, for each option type, the path matrix size and the timing of
+ * simulation and estimators in both modes and the difference of Price, Delta
+ * and Vega versus the double path. Single precision only changes the storage:
+ * the bytes halve, the times stay close (the Gaussians dominate the simulation).
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Run
+    {
+        double price, stderr_price, delta, vega;
+        double simSeconds, estSeconds;
+        double pathBytes;
+    };
+
+    template <class Option>
+    Run run(int N, double T, ensiie::Precision precision)
+    {
+        ensiie::SimulationSettings settings;
+        settings.precision = precision;
+
+        auto t0 = Clock::now();
+        Option option(0.0, T, 100.0, 0.05, 0.2, N, 1.0, 10, 42, settings);
+        auto t1 = Clock::now();
+
+        Run r;
+        r.price = option.price();
+        r.stderr_price = std::exp(-0.05 * T) * option.payoff_stderr();
+        r.delta = option.delta();
+        r.vega = option.vega();
+        auto t2 = Clock::now();
+
+        r.pathBytes = option.visit_paths([](const auto& paths)
+            {
+                return static_cast<double>(paths.rows()) * paths.cols() * sizeof(paths[0][0]);
+            });
+        r.simSeconds = std::chrono::duration<double>(t1 - t0).count();
+        r.estSeconds = std::chrono::duration<double>(t2 - t1).count();
+        return r;
+    }
+
+    template <class Option>
+    void compare(const std::string& name, int N, double T)
+    {
+        const Run d = run<Option>(N, T, ensiie::Precision::Double);
+        const Run f = run<Option>(N, T, ensiie::Precision::Single);
+
+        std::cout << name << " double: paths " << d.pathBytes / 1e6 << " MB, sim " << d.simSeconds
+            << "s, estimators " << d.estSeconds << "s\n"
+            << name << " single: paths " << f.pathBytes / 1e6 << " MB, sim " << f.simSeconds
+            << "s, estimators " << f.estSeconds << "s\n"
+            << name << " price " << d.price << " (stderr " << d.stderr_price << ")"
+            << ", single - double: price " << f.price - d.price
+            << ", delta " << f.delta - d.delta
+            << ", vega " << f.vega - d.vega
+            << ", |dprice| / stderr " << std::fabs(f.price - d.price) / d.stderr_price << "\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int N = (argc > 1) ? std::stoi(argv[1]) : 100000;
+    const double T = (argc > 2) ? std::stod(argv[2]) : 1.0;
+
+    std::cout << std::setprecision(6) << "N = " << N << ", T = " << T << "\n";
+    compare<ensiie::Call>("call", N, T);
+    compare<ensiie::Put>("put", N, T);
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "Call.h"
+#include "put.h"
+#include "Richardson.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Compares Richardson extrapolation on coarse grids with plain fine grids.
+ *
+ * Usage: richardson_bench [N]
+ * For a fresh at-the-money option (T = 1, r = 5%, sigma = 20%), prints the
+ * continuously monitored closed form, then the price, error and time of plain
+ * runs on the daily grid and of Richardson extrapolations from coarser grids.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    const double S0 = 100.0, r = 0.05, sigma = 0.2, T = 1.0;
+
+    double normal_cdf(double x)
+    {
+        return 0.5 * std::erfc(-x / std::sqrt(2.0));
+    }
+
+    /** @brief Continuously monitored floating-strike lookback, fresh trade (Goldman, Sosin and Gatto). */
+    double closed_form(bool call)
+    {
+        const double a1 = (r + 0.5 * sigma * sigma) * T / (sigma * std::sqrt(T));
+        const double a2 = a1 - sigma * std::sqrt(T);
+        const double a3 = (-r + 0.5 * sigma * sigma) * T / (sigma * std::sqrt(T));
+        const double k = sigma * sigma / (2.0 * r);
+        const double discount = std::exp(-r * T);
+
+        if (call)
+            return S0 * normal_cdf(a1) - S0 * k * normal_cdf(-a1)
+                - S0 * discount * (normal_cdf(a2) - k * normal_cdf(-a3));
+
+        return -S0 * normal_cdf(-a1) + S0 * k * normal_cdf(a1)
+            + S0 * discount * (normal_cdf(-a2) - k * normal_cdf(a3));
+    }
+
+    template <class Option>
+    void compare(const std::string& name, int N)
+    {
+        const bool call = (name == "call");
+        const double exact = closed_form(call);
+        std::cout << name << " continuous closed form " << exact << "\n";
+
+        auto t0 = Clock::now();
+        Option daily(0.0, T, S0, r, sigma, N, 1.0, 10, 42);
+        const double price = daily.price();
+        auto t1 = Clock::now();
+
+        std::cout << name << " daily grid (252 steps): price " << price
+            << ", error " << price - exact
+            << ", time " << std::chrono::duration<double>(t1 - t0).count() << "s\n";
+
+        const int coarse[] = { 12, 52 };
+        const int refinement[] = { 2, 4 };
+        for (int steps : coarse)
+        {
+            for (int m : refinement)
+            {
+                t0 = Clock::now();
+                const ensiie::RichardsonEstimator estimator(0.0, T, S0, r, sigma, N, name, 42, steps, m);
+                const ensiie::RichardsonResult res = estimator.run();
+                t1 = Clock::now();
+
+                std::cout << name << " Richardson " << steps << " x " << m << " steps: price " << res.price
+                    << " (stderr " << res.std_error << ")"
+                    << ", error " << res.price - exact
+                    << ", fine-grid bias " << res.bias
+                    << ", time " << std::chrono::duration<double>(t1 - t0).count() << "s\n";
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int N = (argc > 1) ? std::stoi(argv[1]) : 100000;
+
+    std::cout << std::setprecision(6) << "N = " << N << "\n";
+    compare<ensiie::Call>("call", N);
+    compare<ensiie::Put>("put", N);
+    return 0;
+}
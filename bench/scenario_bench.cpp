@@ -0,0 +1,86 @@
+#include "ScenarioEngine.h"
+#include "Call.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Scenario grid with common random numbers versus one Call per scenario.
+ *
+ * Usage: scenario_bench [N]
+ * Prices a 3 x 3 x 2 x 3 (S0, sigma, r, t) grid with one ScenarioEngine and
+ * with one Call object per scenario, prints both times and checks that every
+ * scenario at the base valuation time (same normals as the Call of the same
+ * seed) matches Call::price(), the base scenario included.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double seconds(Clock::time_point t0)
+    {
+        return std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int N = (argc > 1) ? std::stoi(argv[1]) : 10000;
+    const double t = 0.0, T = 1.0, S0 = 100.0, r = 0.05, sigma = 0.2;
+    const unsigned long seed = 42;
+
+    ensiie::ScenarioGrid grid;
+    grid.S0 = { 90.0, S0, 110.0 };
+    grid.sigma = { 0.15, sigma, 0.25 };
+    grid.r = { 0.03, r };
+    grid.t = { t, 0.25, 0.5 };
+
+    auto t0 = Clock::now();
+    const ensiie::ScenarioEngine engine(ensiie::OptionType::Call, t, T, S0, r, sigma, N, seed);
+    const ensiie::ScenarioResult result = engine.run(grid);
+    const double engineSeconds = seconds(t0);
+
+    // The log-space walk and the GBM product round differently: agreement to 1e-10
+    const double tolerance = 1e-10;
+    double worst = 0.0;
+    int mismatches = 0;
+
+    t0 = Clock::now();
+    for (size_t iS0 = 0; iS0 < result.nS0; ++iS0)
+        for (size_t iSigma = 0; iSigma < result.nSigma; ++iSigma)
+            for (size_t iR = 0; iR < result.nR; ++iR)
+                for (size_t iT = 0; iT < result.nT; ++iT)
+                {
+                    const ensiie::Call call(grid.t[iT], T, grid.S0[iS0], grid.r[iR], grid.sigma[iSigma],
+                        N, 1.0, 10, seed);
+                    const double price = call.price();
+
+                    // Later valuation times draw a shorter stream: other normals, no check
+                    if (iT != 0)
+                        continue;
+
+                    const double scenario = result.price[result.index(iS0, iSigma, iR, iT)];
+                    const double error = std::abs(scenario - price) / std::max(1.0, std::abs(price));
+                    worst = std::max(worst, error);
+                    if (error > tolerance)
+                        ++mismatches;
+
+                    if (grid.S0[iS0] == S0 && grid.sigma[iSigma] == sigma && grid.r[iR] == r)
+                        std::cout << std::setprecision(12) << "base scenario " << scenario
+                            << ", Call::price() " << price << "\n";
+                }
+    const double callSeconds = seconds(t0);
+
+    const size_t count = result.price.size();
+    std::cout << std::setprecision(6) << count << " scenarios, N = " << N << "\n"
+        << "scenario engine: " << engineSeconds << "s\n"
+        << "one Call per scenario: " << callSeconds << "s\n"
+        << "speedup " << callSeconds / engineSeconds << "x; scenarios at t = " << t
+        << " versus Call: max relative difference " << worst << ", " << mismatches << " above " << tolerance << "\n";
+    return mismatches == 0 ? 0 : 1;
+}
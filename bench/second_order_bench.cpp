@@ -0,0 +1,78 @@
+#include "Call.h"
+#include "put.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+
+/**
+ * @brief Second-order Greeks from the base paths versus bump and reprice.
+ *
+ * Usage: second_order_bench [N] [fixings_per_year]
+ * For fresh and seasoned calls and puts, prints Gamma, Vanna and Volga of
+ * second_order_greeks() and their central finite differences of the pathwise
+ * Delta and Vega over re-simulated bumped runs (common random numbers), with
+ * the time of each relative to one price.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double seconds(Clock::time_point t0)
+    {
+        return std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+
+    template <class Option>
+    void compare(const std::string& name, int N, double runningExtreme, double perYear)
+    {
+        const double S0 = 100.0, r = 0.04, sigma = 0.25, hS = 0.5, hSigma = 0.01;
+
+        ensiie::SimulationSettings settings;
+        settings.running_extreme = runningExtreme;
+        if (perYear > 0.0)
+            settings.fixing_dates = ensiie::MonteCarlo::regular_fixings(0.0, 1.0, perYear);
+
+        auto t0 = Clock::now();
+        Option base(0.0, 1.0, S0, r, sigma, N, 1.0, 10, 42, settings);
+        const double price = base.price();
+        const double priceSeconds = seconds(t0);
+
+        t0 = Clock::now();
+        const ensiie::Pricing::SecondOrderGreeks g = base.second_order_greeks();
+        const double ladderSeconds = seconds(t0);
+
+        t0 = Clock::now();
+        Option up(0.0, 1.0, S0 + hS, r, sigma, N, 1.0, 10, 42, settings);
+        Option down(0.0, 1.0, S0 - hS, r, sigma, N, 1.0, 10, 42, settings);
+        Option volUp(0.0, 1.0, S0, r, sigma + hSigma, N, 1.0, 10, 42, settings);
+        Option volDown(0.0, 1.0, S0, r, sigma - hSigma, N, 1.0, 10, 42, settings);
+        const double gammaFd = (up.delta() - down.delta()) / (2.0 * hS);
+        const double vannaFd = (up.vega() - down.vega()) / (2.0 * hS);
+        const double volgaFd = (volUp.vega() - volDown.vega()) / (2.0 * hSigma);
+        const double bumpSeconds = seconds(t0);
+
+        std::cout << name << ": price " << price << " in " << priceSeconds << "s\n"
+            << "  paths:  gamma " << g.gamma << ", vanna " << g.vanna << ", volga " << g.volga
+            << " in " << ladderSeconds << "s (" << ladderSeconds / priceSeconds << " prices)\n"
+            << "  bumped: gamma " << gammaFd << ", vanna " << vannaFd << ", volga " << volgaFd
+            << " in " << bumpSeconds << "s (" << bumpSeconds / priceSeconds << " prices)\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int N = (argc > 1) ? std::stoi(argv[1]) : 100000;
+    const double perYear = (argc > 2) ? std::stod(argv[2]) : 0.0;
+    const double fresh = std::numeric_limits<double>::quiet_NaN();
+
+    std::cout << std::setprecision(6) << "N = " << N << ", fixings per year = " << perYear << " (0: daily)\n";
+    compare<ensiie::Call>("call fresh", N, fresh, perYear);
+    compare<ensiie::Put>("put fresh", N, fresh, perYear);
+    compare<ensiie::Call>("call seasoned at 92", N, 92.0, perYear);
+    compare<ensiie::Put>("put seasoned at 106", N, 106.0, perYear);
+    return 0;
+}
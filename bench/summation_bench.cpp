@@ -0,0 +1,144 @@
+#include "Estimator.h"
+#include "Summation.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Accuracy, speed and reproducibility of the estimator reductions.
+ *
+ * Usage: summation_bench [N]
+ * Sums N lookback-like payoffs (positive, heavy right tail) with a naive
+ * sequential double sum, a sequential Kahan sum and the fixed-shape block
+ * reduction (block_totals() and fold_blocks()), and prints the error of each
+ * against a long double compensated reference and the time per value. The block
+ * reduction is then recomputed on thread pools of 1, 2, 4 and 7 workers, each
+ * with several chunk sizes (blocks per work item), to check that the result
+ * keeps the same bits whatever the thread count and the split.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    template <class F>
+    double timed(const std::string& name, int N, double reference, F&& sum)
+    {
+        const auto t0 = Clock::now();
+        const double value = sum();
+        const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        std::cout << name << ": relative error " << std::abs(value - reference) / std::abs(reference)
+            << ", " << seconds / N * 1e9 << " ns/value\n";
+        return value;
+    }
+
+    /**
+     * @brief Block totals of values computed on a pool of threads workers, chunk
+     * blocks per work item handed out dynamically, then folded by fold_blocks().
+     */
+    double pool_sum(const std::vector<double>& values, unsigned int threads, int chunk)
+    {
+        const int N = static_cast<int>(values.size());
+        const int nBlocks = ensiie::MonteCarlo::block_count(N);
+        const int nItems = (nBlocks + chunk - 1) / chunk;
+        std::vector<double> totals(nBlocks);
+        std::atomic<int> next{ 0 };
+
+        {
+            ensiie::ThreadPool pool(threads);
+            for (unsigned int w = 0; w < threads; ++w)
+            {
+                pool.submit([&]()
+                    {
+                        for (int item = next++; item < nItems; item = next++)
+                        {
+                            for (int b = item * chunk; b < std::min(nBlocks, (item + 1) * chunk); ++b)
+                            {
+                                const int first = b * ensiie::MonteCarlo::block_size;
+                                totals[b] = ensiie::block_sum(values.data() + first,
+                                    std::min(ensiie::MonteCarlo::block_size, N - first));
+                            }
+                        }
+                    });
+            }
+        }   // The pool drains its jobs and joins here
+
+        return ensiie::fold_blocks(nBlocks, [&](int b) { return totals[b]; });
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int N = (argc > 1) ? std::stoi(argv[1]) : 10000000;
+
+    // S_T - min S over a year, roughly: lognormal terminal value minus a smaller extreme
+    std::mt19937_64 gen(42);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<double> values(N);
+    for (double& v : values)
+        v = 100.0 * std::exp(0.2 * normal(gen)) - 80.0 * std::exp(-0.1 * std::abs(normal(gen)));
+
+    long double ref = 0.0L, c = 0.0L;
+    for (double v : values)
+    {
+        const long double y = v - c;
+        const long double t = ref + y;
+        c = (t - ref) - y;
+        ref = t;
+    }
+    const double reference = static_cast<double>(ref);
+
+    std::cout << std::setprecision(3) << "N = " << N << "\n";
+
+    timed("naive", N, reference, [&]()
+        {
+            double sum = 0.0;
+            for (double v : values)
+                sum += v;
+            return sum;
+        });
+
+    timed("kahan", N, reference, [&]()
+        {
+            ensiie::KahanSum sum;
+            for (double v : values)
+                sum.add(v);
+            return sum.value();
+        });
+
+    const double blocked = timed("block tree", N, reference, [&]()
+        {
+            return ensiie::in_thread_arena([&]()
+                {
+                    const ensiie::ArenaVector<double> totals = ensiie::block_totals(values.data(), N);
+                    return ensiie::fold_blocks(static_cast<int>(totals.size()), [&](int b) { return totals[b]; });
+                });
+        });
+
+    // Same blocks computed by explicitly sized pools and work items of different sizes
+    const unsigned int pools[] = { 1, 2, 4, 7 };
+    const int chunks[] = { 1, 3, 16, 100 };
+    int differences = 0;
+    for (unsigned int threads : pools)
+    {
+        for (int chunk : chunks)
+        {
+            const double sum = pool_sum(values, threads, chunk);
+            if (sum != blocked)
+                ++differences;
+
+            std::cout << threads << " workers, chunks of " << chunk << " blocks: "
+                << (sum == blocked ? "identical bits" : "DIFFERENT BITS") << "\n";
+        }
+    }
+
+    return differences == 0 ? 0 : 1;
+}
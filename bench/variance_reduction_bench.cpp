@@ -0,0 +1,89 @@
+#include "Call.h"
+#include "put.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Compares the sampling schemes on the same option.
+ *
+ * Usage: variance_reduction_bench [N] [strata] [drift_shift]
+ * Prints, for each option type, the price, standard error, run time and
+ * efficiency 1 / (variance x time) of antithetic sampling, stratified
+ * sampling, importance sampling and stratified + importance sampling,
+ * followed by the per-stratum payoff statistics of the stratified run.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Scheme
+    {
+        const char* name;
+        ensiie::Sampling sampling;
+        bool shifted;
+    };
+
+    template <class Option>
+    void compare(const std::string& name, int N, int strata, double shift)
+    {
+        const double T = 1.0;
+        const double discount = std::exp(-0.05 * T);
+
+        const Scheme schemes[] = {
+            { "antithetic", ensiie::Sampling::Antithetic, false },
+            { "stratified", ensiie::Sampling::Stratified, false },
+            { "importance", ensiie::Sampling::Antithetic, true },
+            { "stratified+importance", ensiie::Sampling::Stratified, true }
+        };
+
+        for (const Scheme& scheme : schemes)
+        {
+            ensiie::SimulationSettings settings;
+            settings.sampling = scheme.sampling;
+            settings.strata = strata;
+            settings.drift_shift = scheme.shifted ? shift : 0.0;
+
+            auto t0 = Clock::now();
+            Option option(0.0, T, 100.0, 0.05, 0.2, N, 1.0, 10, 42, settings);
+            const double price = option.price();
+            auto t1 = Clock::now();
+
+            const double seconds = std::chrono::duration<double>(t1 - t0).count();
+            const double stderrPrice = discount * option.stratified_stderr();
+
+            std::cout << name << " " << scheme.name << ": price " << price
+                << ", stderr " << stderrPrice
+                << ", time " << seconds << "s"
+                << ", efficiency " << 1.0 / (stderrPrice * stderrPrice * seconds) << "\n";
+
+            // Per-stratum report of the plain stratified run
+            if (scheme.sampling == ensiie::Sampling::Stratified && !scheme.shifted)
+            {
+                const auto strata = option.stratum_statistics();
+                for (size_t j = 0; j < strata.size(); ++j)
+                {
+                    std::cout << "  stratum " << j << ": paths " << strata[j].count
+                        << ", mean payoff " << strata[j].mean
+                        << ", std " << std::sqrt(strata[j].variance) << "\n";
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int N = (argc > 1) ? std::stoi(argv[1]) : 65536;
+    const int strata = (argc > 2) ? std::stoi(argv[2]) : 16;
+    const double shift = (argc > 3) ? std::stod(argv[3]) : 0.5;
+
+    std::cout << std::setprecision(6) << "N = " << N << ", strata = " << strata
+        << ", drift shift = " << shift << "\n";
+    compare<ensiie::Call>("call", N, strata, shift);
+    compare<ensiie::Put>("put", N, strata, -shift);
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include "AllocationStats.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace ensiie
+{
+#ifdef LOOKBACK_ALLOC_STATS
+    namespace
+    {
+        std::atomic<long long> allocationCount{ 0 };
+        std::atomic<long long> deallocationCount{ 0 };
+        std::atomic<long long> allocatedBytes{ 0 };
+
+        void* counted_malloc(std::size_t size, std::size_t alignment)
+        {
+            allocationCount.fetch_add(1, std::memory_order_relaxed);
+            allocatedBytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+
+            if (size == 0)
+                size = 1;
+
+            if (alignment <= alignof(std::max_align_t))
+                return std::malloc(size);
+
+            // aligned_alloc requires a multiple of the alignment
+            return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        }
+
+        void counted_free(void* p)
+        {
+            if (!p)
+                return;
+            deallocationCount.fetch_add(1, std::memory_order_relaxed);
+            std::free(p);
+        }
+
+        void* throwing_malloc(std::size_t size, std::size_t alignment)
+        {
+            for (;;)
+            {
+                if (void* p = counted_malloc(size, alignment))
+                    return p;
+
+                std::new_handler handler = std::get_new_handler();
+                if (!handler)
+                    throw std::bad_alloc();
+                handler();
+            }
+        }
+    }
+#endif
+
+    bool allocation_counting_enabled()
+    {
+#ifdef LOOKBACK_ALLOC_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    AllocationStats allocation_stats()
+    {
+        AllocationStats s;
+#ifdef LOOKBACK_ALLOC_STATS
+        s.allocations = allocationCount.load(std::memory_order_relaxed);
+        s.deallocations = deallocationCount.load(std::memory_order_relaxed);
+        s.bytes = allocatedBytes.load(std::memory_order_relaxed);
+#endif
+        return s;
+    }
+
+    AllocationStats operator-(const AllocationStats& after, const AllocationStats& before)
+    {
+        AllocationStats d;
+        d.allocations = after.allocations - before.allocations;
+        d.deallocations = after.deallocations - before.deallocations;
+        d.bytes = after.bytes - before.bytes;
+        return d;
+    }
+}
+
+#ifdef LOOKBACK_ALLOC_STATS
+
+// Replacement global allocation functions (counted)
+
+void* operator new(std::size_t size)
+{
+    return ensiie::throwing_malloc(size, 0);
+}
+
+void* operator new[](std::size_t size)
+{
+    return ensiie::throwing_malloc(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return ensiie::throwing_malloc(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ensiie::throwing_malloc(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return ensiie::counted_malloc(size, 0);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return ensiie::counted_malloc(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return ensiie::counted_malloc(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return ensiie::counted_malloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept { ensiie::counted_free(p); }
+void operator delete[](void* p) noexcept { ensiie::counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept { ensiie::counted_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { ensiie::counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { ensiie::counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { ensiie::counted_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { ensiie::counted_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { ensiie::counted_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { ensiie::counted_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { ensiie::counted_free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { ensiie::counted_free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { ensiie::counted_free(p); }
+
+#endif
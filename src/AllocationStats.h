@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+
+namespace ensiie
+{
+    /**
+     * @brief Process-wide heap allocation counters.
+     *
+     * Counted by the replacement global operator new/delete of AllocationStats.cpp,
+     * so every heap allocation of the process is seen, whichever library makes it.
+     * Arena chunks are heap allocations too: at steady state a request served
+     * from a warm arena adds none.
+     *
+     * The replacement is only compiled with -DLOOKBACK_ALLOC_STATS (benches and
+     * instrumented builds): the default pricer keeps the plain allocator, without
+     * shared atomic increments on every allocation, and its counters stay at zero.
+     */
+    struct AllocationStats
+    {
+        long long allocations = 0;     ///< Calls to operator new (all variants)
+        long long deallocations = 0;   ///< Calls to operator delete on a non-null pointer
+        long long bytes = 0;           ///< Bytes requested from operator new
+    };
+
+    /** @brief True if the process was built with the counting allocator (-DLOOKBACK_ALLOC_STATS). */
+    bool allocation_counting_enabled();
+
+    /** @brief Counters since the start of the process. */
+    AllocationStats allocation_stats();
+
+    /** @brief Difference of two snapshots (after - before). */
+    AllocationStats operator-(const AllocationStats& after, const AllocationStats& before);
+}
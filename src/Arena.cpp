@@ -0,0 +1,149 @@
+#include "Arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+
+namespace ensiie
+{
+    namespace
+    {
+        /** @brief Chunk alignment: a cache line, so path rows start aligned for the scans. */
+        const std::size_t chunkAlignment = 64;
+
+        thread_local std::pmr::memory_resource* currentResource = nullptr;
+
+        /** @brief First offset at or after offset whose address in data is a multiple of alignment (a power of two). */
+        std::size_t aligned_offset(const char* data, std::size_t offset, std::size_t alignment)
+        {
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(data) + offset;
+            const std::uintptr_t aligned = (address + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+            return offset + static_cast<std::size_t>(aligned - address);
+        }
+    }
+
+    Arena::Arena(std::size_t initialBytes, std::size_t retainedBytes)
+        : initialBytes_(std::max<std::size_t>(initialBytes, 4096)), retainedBytes_(retainedBytes)
+    {
+    }
+
+    Arena::~Arena()
+    {
+        free_chunks();
+    }
+
+    void Arena::add_chunk(std::size_t bytes)
+    {
+        // Geometric growth keeps the number of chunks logarithmic in the request size
+        const std::size_t size = std::max({ bytes, initialBytes_, capacity() });
+
+        char* data = static_cast<char*>(::operator new(size, std::align_val_t(chunkAlignment)));
+        chunks_.push_back(Chunk{ data, size });
+        offset_ = 0;
+        ++chunkAllocations_;
+    }
+
+    void Arena::free_chunks()
+    {
+        for (const Chunk& c : chunks_)
+            ::operator delete(c.data, std::align_val_t(chunkAlignment));
+        chunks_.clear();
+    }
+
+    std::size_t Arena::capacity() const
+    {
+        std::size_t total = 0;
+        for (const Chunk& c : chunks_)
+            total += c.size;
+        return total;
+    }
+
+    void Arena::reset()
+    {
+        if (scopes_ > 0)
+            throw std::logic_error("Arena reset while an ArenaScope is active.");
+
+        const std::size_t total = capacity();
+
+        // Above the retained size: back to the heap, the next request starts from a small chunk
+        if (total > retainedBytes_)
+        {
+            free_chunks();
+        }
+        // Overflowed: one chunk of the total size serves the next request alone
+        else if (chunks_.size() > 1)
+        {
+            free_chunks();
+            try
+            {
+                add_chunk(total);
+            }
+            catch (const std::bad_alloc&)
+            {
+                // Called from destructors (in_thread_arena): the next allocation adds a chunk
+            }
+        }
+
+        offset_ = 0;
+        used_ = 0;
+    }
+
+    void* Arena::do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        // The address is aligned, not the offset: chunks are only chunkAlignment-aligned
+        if (!chunks_.empty())
+        {
+            const Chunk& c = chunks_.back();
+            const std::size_t start = aligned_offset(c.data, offset_, alignment);
+            if (start + bytes <= c.size)
+            {
+                offset_ = start + bytes;
+                used_ += bytes;
+                return c.data + start;
+            }
+        }
+
+        // Room for the padding up to any alignment above the chunk's
+        add_chunk(bytes + alignment);
+
+        const Chunk& c = chunks_.back();
+        const std::size_t start = aligned_offset(c.data, 0, alignment);
+        offset_ = start + bytes;
+        used_ += bytes;
+        return c.data + start;
+    }
+
+    void Arena::do_deallocate(void*, std::size_t, std::size_t)
+    {
+        // Monotonic: memory is released by reset()
+    }
+
+    bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+
+    Arena& thread_arena()
+    {
+        thread_local Arena arena(1 << 20, thread_arena_retained_bytes);
+        return arena;
+    }
+
+    std::pmr::memory_resource* current_resource()
+    {
+        return currentResource ? currentResource : std::pmr::new_delete_resource();
+    }
+
+    ArenaScope::ArenaScope(Arena& arena)
+        : arena_(arena), previous_(currentResource)
+    {
+        currentResource = &arena;
+        ++arena.scopes_;
+    }
+
+    ArenaScope::~ArenaScope()
+    {
+        --arena_.scopes_;
+        currentResource = previous_;
+    }
+}
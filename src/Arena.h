@@ -0,0 +1,204 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace ensiie
+{
+    /**
+     * @brief Monotonic arena for the buffers of one request.
+     *
+     * Allocation bumps an offset in a chunk; deallocation is a no-op and the
+     * whole arena is released at once by reset(). If a request overflowed the
+     * first chunk, reset() replaces the chunks by a single one of the total
+     * size, so after the first request of a given size the arena serves every
+     * allocation without touching the heap and reset() is O(1). Chunks above
+     * the retained size are returned to the heap instead, so a long-lived
+     * arena does not keep the peak of its largest request.
+     *
+     * Not thread-safe: one arena per thread (thread_arena()) or per request.
+     */
+    class Arena : public std::pmr::memory_resource
+    {
+    public:
+        /**
+         * @brief Constructor; the first chunk is allocated on first use.
+         * @param initialBytes Size of the first chunk.
+         * @param retainedBytes Largest total chunk size kept by reset() (unbounded by default).
+         */
+        explicit Arena(std::size_t initialBytes = 1 << 20,
+            std::size_t retainedBytes = static_cast<std::size_t>(-1));
+
+        ~Arena() override;
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /**
+         * @brief Releases every allocation at once.
+         *
+         * Nothing allocated from the arena may be used afterwards. Frees the
+         * chunks if their total exceeds the retained size. Throws
+         * std::logic_error if an ArenaScope on this arena is still active.
+         */
+        void reset();
+
+        /** @brief Bytes handed out since the last reset(). */
+        std::size_t bytes_used() const { return used_; }
+
+        /** @brief Total size of the chunks. */
+        std::size_t capacity() const;
+
+        /** @brief Number of chunks obtained from the heap since construction. */
+        long long chunk_allocations() const { return chunkAllocations_; }
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        friend class ArenaScope;
+
+        struct Chunk
+        {
+            char* data;
+            std::size_t size;
+        };
+
+        std::size_t initialBytes_;
+        std::size_t retainedBytes_;
+        std::vector<Chunk> chunks_;
+        std::size_t offset_ = 0;          ///< Offset in the last chunk
+        std::size_t used_ = 0;
+        long long chunkAllocations_ = 0;
+        int scopes_ = 0;                  ///< Active ArenaScope objects
+
+        /** @brief Appends a chunk of at least bytes bytes. */
+        void add_chunk(std::size_t bytes);
+
+        /** @brief Frees every chunk. */
+        void free_chunks();
+    };
+
+    /** @brief Largest total chunk size a thread arena keeps between tasks. */
+    constexpr std::size_t thread_arena_retained_bytes = std::size_t(256) << 20;
+
+    /** @brief Arena of the calling thread (keeps at most thread_arena_retained_bytes across resets). */
+    Arena& thread_arena();
+
+    /**
+     * @brief Resource of the engine buffers allocated by the calling thread: the
+     * arena of the innermost ArenaScope, or the heap outside any scope.
+     */
+    std::pmr::memory_resource* current_resource();
+
+    /**
+     * @brief Makes an arena the current resource of the calling thread.
+     *
+     * Containers using ArenaAllocator that are created inside the scope take
+     * their memory from the arena; the previous resource is restored on exit.
+     */
+    class ArenaScope
+    {
+    public:
+        explicit ArenaScope(Arena& arena);
+        ~ArenaScope();
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+    private:
+        Arena& arena_;
+        std::pmr::memory_resource* previous_;
+    };
+
+    /**
+     * @brief Runs fn with the thread's arena as current resource, then releases
+     * the arena (unless an enclosing scope still uses it).
+     *
+     * Whatever fn allocates must not outlive the call: return plain values.
+     */
+    template <class F>
+    decltype(auto) in_thread_arena(F&& fn)
+    {
+        struct Release
+        {
+            Arena& arena;
+            ~Release()
+            {
+                if (&arena != current_resource())
+                    arena.reset();
+            }
+        } release{ thread_arena() };
+
+        ArenaScope scope(release.arena);
+        return fn();
+    }
+
+    /**
+     * @brief Polymorphic allocator bound, at construction, to current_resource().
+     *
+     * Copies of a container are allocated from the resource current at the
+     * time of the copy.
+     */
+    template <class T>
+    class ArenaAllocator : public std::pmr::polymorphic_allocator<T>
+    {
+    public:
+        ArenaAllocator() noexcept : std::pmr::polymorphic_allocator<T>(current_resource()) {}
+
+        ArenaAllocator(std::pmr::memory_resource* resource) noexcept
+            : std::pmr::polymorphic_allocator<T>(resource) {}
+
+        template <class U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+            : std::pmr::polymorphic_allocator<T>(other.resource()) {}
+
+        ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+    };
+
+    /** @brief Vector whose storage comes from the current arena. */
+    template <class T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+    /** @brief Deleter of objects created by make_arena(): destroys, then returns the memory to its resource. */
+    struct ArenaDeleter
+    {
+        std::pmr::memory_resource* resource = nullptr;
+        std::size_t size = 0;
+        std::size_t alignment = 0;
+
+        template <class T>
+        void operator()(T* p) const
+        {
+            p->~T();
+            resource->deallocate(p, size, alignment);
+        }
+    };
+
+    /** @brief Owning pointer to an object created by make_arena(). */
+    template <class T>
+    using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+    /** @brief Creates a T in current_resource() (the heap outside any ArenaScope). */
+    template <class T, class... Args>
+    ArenaPtr<T> make_arena(Args&&... args)
+    {
+        std::pmr::memory_resource* resource = current_resource();
+        void* memory = resource->allocate(sizeof(T), alignof(T));
+
+        try
+        {
+            T* p = new (memory) T(std::forward<Args>(args)...);
+            return ArenaPtr<T>(p, ArenaDeleter{ resource, sizeof(T), alignof(T) });
+        }
+        catch (...)
+        {
+            resource->deallocate(memory, sizeof(T), alignof(T));
+            throw;
+        }
+    }
+}
@@ -0,0 +1,182 @@
+#include "BatchEngine.h"
+#include "MonteCarlo.h"
+#include "Numa.h"
+#include "Parallel.h"
+#include "Summation.h"
+#include "TermStructure.h"
+#include "Estimator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+namespace ensiie
+{
+    namespace
+    {
+        /** @brief Time step of the daily grid (as MonteCarlo). */
+        const double dt = 1.0 / 252.0;
+    }
+
+    BatchEngine::BatchEngine(std::vector<BatchTrade> trades)
+        : trades_(std::move(trades))
+    {
+        // Same checks and messages as a single-trade run: Data, then MonteCarlo
+        for (int j = 0; j < static_cast<int>(trades_.size()); ++j)
+        {
+            const BatchTrade& d = trades_[j];
+            const Data inputs(d.t, d.T, d.S0, d.r, d.sigma, d.N, 1.0, 1,
+                d.type == OptionType::Call ? "call" : "put", d.seed);
+            MonteCarlo::check_grid_and_volatility(step_count(j), d.sigma, true);
+        }
+
+        // Group by time grid, then pack whole blocks into chunks in trade order
+        std::map<int, std::vector<int>> groups;
+        for (int j = 0; j < static_cast<int>(trades_.size()); ++j)
+            groups[step_count(j)].push_back(j);
+
+        for (const auto& group : groups)
+        {
+            Chunk chunk{ group.first, 0, {} };
+            for (int j : group.second)
+            {
+                const int N = trades_[j].N;
+                for (int b = 0; b < MonteCarlo::block_count(N); ++b)
+                {
+                    const int count = std::min(MonteCarlo::block_size, N - b * MonteCarlo::block_size);
+                    if (chunk.lanes + count > lane_capacity)
+                    {
+                        chunks_.push_back(std::move(chunk));
+                        chunk = Chunk{ group.first, 0, {} };
+                    }
+
+                    chunk.segments.push_back(Segment{ j, b, chunk.lanes, count });
+                    chunk.lanes += count;
+                }
+            }
+            if (chunk.lanes > 0)
+                chunks_.push_back(std::move(chunk));
+        }
+    }
+
+    int BatchEngine::step_count(int j) const
+    {
+        return std::max(0, static_cast<int>((trades_[j].T - trades_[j].t) * 252.0));
+    }
+
+    void BatchEngine::run_chunk(const Chunk& chunk, std::vector<std::vector<BlockTotals>>& totals) const
+    {
+        const int L = chunk.lanes;
+        const int Nt = chunk.Nt;
+
+        // Per-lane coefficients and running state (structure of arrays)
+        ArenaVector<double> drift(L), diffusion(L), direction(L), S(L), ext(L);
+        ArenaVector<int> extIndex(L, 0);
+        ArenaVector<double> Z(static_cast<size_t>(Nt) * L);
+
+        for (const Segment& seg : chunk.segments)
+        {
+            const BatchTrade& d = trades_[seg.trade];
+            MonteCarlo::block_normals(d.seed, d.N, Nt, seg.block, Z.data() + seg.first_lane, L);
+
+            // Same expressions as MonteCarlo::build_step_tables(), so the paths are bit-identical
+            for (int i = seg.first_lane; i < seg.first_lane + seg.count; ++i)
+            {
+                drift[i] = (d.r - 0.5 * d.sigma * d.sigma) * dt;
+                diffusion[i] = d.sigma * std::sqrt(dt);
+                direction[i] = (d.type == OptionType::Call) ? 1.0 : -1.0;
+                S[i] = d.S0;
+                ext[i] = d.S0;
+            }
+        }
+
+        // Fused step: GBM update, running extreme and its first index, lane by lane
+        for (int k = 1; k <= Nt; ++k)
+        {
+            const double* z = Z.data() + static_cast<size_t>(k - 1) * L;
+            for (int i = 0; i < L; ++i)
+            {
+                const double s = S[i] * std::exp(drift[i] + diffusion[i] * z[i]);
+                S[i] = s;
+
+                // Calls beat from below, puts from above (direction is exactly +-1)
+                const bool beats = direction[i] * s < direction[i] * ext[i];
+                ext[i] = beats ? s : ext[i];
+                extIndex[i] = beats ? k : extIndex[i];
+            }
+        }
+
+        // Block moments and totals, in path order inside each block (as block_moments())
+        ArenaVector<double> payoff(L);
+        for (const Segment& seg : chunk.segments)
+        {
+            const BatchTrade& d = trades_[seg.trade];
+            const double sign = (d.type == OptionType::Call) ? 1.0 : -1.0;
+            const double vegaDrift = d.r + 0.5 * d.sigma * d.sigma;
+
+            // Closed form of the pathwise vega at node k (kernels::pathwise_vega)
+            auto dS_dsigma = [&](double s, int k)
+            {
+                return s * (std::log(s / d.S0) - vegaDrift * k * dt) / d.sigma;
+            };
+
+            BlockAccumulator vega;
+            for (int i = seg.first_lane; i < seg.first_lane + seg.count; ++i)
+            {
+                payoff[i] = sign * (S[i] - ext[i]);
+                vega.add(sign * (dS_dsigma(S[i], Nt) - dS_dsigma(ext[i], extIndex[i])));
+            }
+
+            totals[seg.trade][seg.block] = BlockTotals{
+                sample_moments(payoff.data() + seg.first_lane, seg.count), vega.value() };
+        }
+    }
+
+    std::vector<BatchResult> BatchEngine::run() const
+    {
+        std::vector<std::vector<BlockTotals>> totals(trades_.size());
+        for (size_t j = 0; j < trades_.size(); ++j)
+            totals[j].resize(MonteCarlo::block_count(trades_[j].N));
+
+        // Chunks write disjoint blocks; each worker reuses its arena from chunk to chunk
+        parallel_for(static_cast<int>(chunks_.size()), [&](int c)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                in_thread_arena([&]() { run_chunk(chunks_[c], totals); });
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                record_node_work(static_cast<long long>(chunks_[c].lanes) * chunks_[c].Nt, elapsed.count());
+            });
+
+        std::vector<BatchResult> results(trades_.size());
+        for (size_t j = 0; j < trades_.size(); ++j)
+        {
+            const BatchTrade& d = trades_[j];
+            const std::vector<BlockTotals>& t = totals[j];
+            const int nBlocks = static_cast<int>(t.size());
+            const double n = static_cast<double>(d.N);
+
+            // Folded in block order, as Pricing::sum_over_paths() and Pricing::payoff_std()
+            const Moments payoff = fold_moments(nBlocks, [&](int b) { return t[b].payoff; });
+            const double discount = discount_factor(d.r, TermStructure(), d.t, d.T);
+
+            BatchResult& res = results[j];
+            res.price = discount * payoff.mean();
+            res.price_stderr = discount * payoff.std_error();
+            res.delta = res.price / d.S0;
+            res.vega = discount * (fold_blocks(nBlocks, [&](int b) { return t[b].vega; }) / n);
+        }
+
+        return results;
+    }
+
+    int BatchEngine::get_trade_count() const
+    {
+        return static_cast<int>(trades_.size());
+    }
+
+    int BatchEngine::get_chunk_count() const
+    {
+        return static_cast<int>(chunks_.size());
+    }
+}
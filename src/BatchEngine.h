@@ -0,0 +1,100 @@
+#pragma once
+#include "data.h"
+#include "Estimator.h"
+#include <vector>
+
+namespace ensiie
+{
+    /** @brief One trade of a batch: a fresh lookback on the daily grid, flat r and sigma. */
+    struct BatchTrade
+    {
+        OptionType type;
+        double t;
+        double T;
+        double S0;
+        double r;
+        double sigma;
+        int N;                 ///< Number of paths
+        unsigned long seed;
+    };
+
+    /** @brief Estimates of one trade of a batch. */
+    struct BatchResult
+    {
+        double price;
+        double price_stderr;
+        double delta;
+        double vega;
+    };
+
+    /**
+     * @brief Prices many small trades together, their paths packed in shared lanes.
+     *
+     * Trades with the same number of steps share a time grid; their blocks of
+     * paths are packed side by side into chunks of up to lane_capacity lanes, each
+     * lane carrying its own spot, step drift and diffusion and extreme direction.
+     * One fused step kernel then advances every lane of a chunk: GBM step, running
+     * extreme and its index, with no path matrix, price grid or per-trade object.
+     *
+     * Every trade keeps its own seeded block streams (MonteCarlo::block_normals),
+     * so its paths, hence its Price, Delta and Vega, are bit-identical to those of
+     * a standalone Call or Put with default settings, whatever the batch around it.
+     */
+    class BatchEngine
+    {
+    public:
+        /** @brief Maximum number of paths advanced together by the step kernel. */
+        static constexpr int lane_capacity = 2048;
+
+        /**
+         * @brief Constructor: validates the trades and packs their blocks into chunks.
+         *
+         * Throws std::invalid_argument, with the same message, for any trade a single
+         * Call or Put run rejects (Data checks, under one day to maturity, sigma <= 0).
+         */
+        explicit BatchEngine(std::vector<BatchTrade> trades);
+
+        /** @brief Simulates every chunk (in parallel) and returns the results in trade order. */
+        std::vector<BatchResult> run() const;
+
+        /** @brief Returns the number of trades. */
+        int get_trade_count() const;
+
+        /** @brief Returns the number of chunks the blocks were packed into. */
+        int get_chunk_count() const;
+
+    private:
+        /** @brief Block b of a trade, occupying lanes [first_lane, first_lane + count) of its chunk. */
+        struct Segment
+        {
+            int trade;
+            int block;
+            int first_lane;
+            int count;
+        };
+
+        /** @brief Blocks of trades sharing a time grid, simulated by one kernel call. */
+        struct Chunk
+        {
+            int Nt;
+            int lanes;
+            std::vector<Segment> segments;
+        };
+
+        /** @brief Payoff moments and vega total of one block. */
+        struct BlockTotals
+        {
+            Moments payoff;
+            double vega;
+        };
+
+        std::vector<BatchTrade> trades_;
+        std::vector<Chunk> chunks_;
+
+        /** @brief Number of daily steps of trade j (as MonteCarlo::build_time_grid()). */
+        int step_count(int j) const;
+
+        /** @brief Runs the step kernel on one chunk and stores the totals of its blocks. */
+        void run_chunk(const Chunk& chunk, std::vector<std::vector<BlockTotals>>& totals) const;
+    };
+}
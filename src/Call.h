@@ -1,5 +1,5 @@
 #pragma once
-#include "pricing.h"
+#include "LookbackPricing.h"
 #include <vector>
 #include <string>
 
@@ -9,8 +9,9 @@ namespace ensiie
      * @brief Class representing the Call Option (implemented with Lookback payoff).
      *
      * The payoff is defined as S_T - min_{0<=t<=T} S_{t}.
+     * Payoff and Greeks are provided by LookbackPricing<LookbackCallPayoff>.
      */
-    class Call : public Pricing
+    class Call : public LookbackPricing<LookbackCallPayoff>
     {
     public:
         /**
@@ -26,51 +27,14 @@ namespace ensiie
          * @param dS Price grid step (inherited parameter).
          * @param M Number of discrete price nodes (inherited parameter).
          * @param seed Random number generator seed.
+         * @param settings Optional simulation settings (e.g. path precision).
          */
         
         Call(double t, double T, double S0, double r, double sigma,
-            int N, double dS, int M, unsigned long seed);
+            int N, double dS, int M, unsigned long seed,
+            const SimulationSettings& settings = SimulationSettings());
 
         /** @brief Default destructor. */
         ~Call() = default;
-
-        /**
-         * @brief Computes the payoff for a specific simulated path.
-         *
-         * @param path Vector containing the simulated price trajectory.
-         * @return The calculated payoff value.
-         */
-        double payoff(const std::vector<double>& path) const override;
-
-        // GREEKS
-
-        /**
-		 * @brief Computes Delta using pathwise approach.
-         * @return The sensitivity of the price to the underlying asset price.
-         */
-        double delta() const override;
-        /**
-		 * @brief Gamma equals zero since Delta is linear in the initial spot S0.
-         * @return The sensitivity of Delta to the underlying asset price.
-         */
-        double gamma() const override;
-
-        /**
-		 * @brief Computes Vega using pathwise apporach..
-         * @return The sensitivity of the price to volatility.
-         */
-        double vega() const override;
-
-        /**
-		 * @brief Computes Theta using Forward Finite Differences.
-         * @return The sensitivity of the price to time passage.
-         */
-        double theta() const override;
-
-        /**
-		 * @brief Computes Rho using Forward Finite Differences.
-         * @return The sensitivity of the price to the risk-free rate.
-         */
-        double rho() const override;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,61 @@
+#include "Cancellation.h"
+#include <limits>
+
+namespace ensiie
+{
+    Cancelled::Cancelled(bool deadline)
+        : std::runtime_error(deadline ? "Deadline exceeded." : "Pricing request cancelled."),
+        deadline_(deadline)
+    {
+    }
+
+    bool Cancelled::deadline_exceeded() const
+    {
+        return deadline_;
+    }
+
+    CancellationToken::CancellationToken()
+        : cancelled_(false), deadline_(std::numeric_limits<Clock::rep>::max())
+    {
+    }
+
+    void CancellationToken::cancel()
+    {
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    void CancellationToken::set_deadline(Clock::time_point deadline)
+    {
+        deadline_.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    void CancellationToken::set_timeout(double seconds)
+    {
+        set_deadline(Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+    }
+
+    bool CancellationToken::cancelled() const
+    {
+        return cancelled_.load(std::memory_order_relaxed);
+    }
+
+    bool CancellationToken::deadline_passed() const
+    {
+        const Clock::rep deadline = deadline_.load(std::memory_order_relaxed);
+        return deadline != std::numeric_limits<Clock::rep>::max()
+            && Clock::now().time_since_epoch().count() >= deadline;
+    }
+
+    bool CancellationToken::stop_requested() const
+    {
+        return cancelled() || deadline_passed();
+    }
+
+    void CancellationToken::throw_if_stop_requested() const
+    {
+        if (cancelled())
+            throw Cancelled(false);
+        if (deadline_passed())
+            throw Cancelled(true);
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+namespace ensiie
+{
+    /**
+     * @brief Thrown by the simulation and reduction loops once a stop is requested.
+     */
+    class Cancelled : public std::runtime_error
+    {
+    public:
+        /** @param deadline true if the deadline passed, false if the request was cancelled. */
+        explicit Cancelled(bool deadline);
+
+        /** @brief Returns true if the deadline passed (the work done so far is still valid). */
+        bool deadline_exceeded() const;
+
+    private:
+        bool deadline_;
+    };
+
+    /**
+     * @brief Cooperative cancellation flag and deadline of one pricing request.
+     *
+     * Shared by every object of the request through SimulationSettings. The loops
+     * poll it once per block of paths (MonteCarlo::block_size paths) and once per
+     * reduction, so the cost is one relaxed load and, with a deadline, one clock
+     * read per block.
+     */
+    class CancellationToken
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /** @brief Constructor of a token without deadline. */
+        CancellationToken();
+
+        /** @brief Requests a stop (e.g. a newer request for the same trade). Thread-safe. */
+        void cancel();
+
+        /** @brief Sets the deadline. Thread-safe. */
+        void set_deadline(Clock::time_point deadline);
+
+        /** @brief Sets the deadline to seconds from now. */
+        void set_timeout(double seconds);
+
+        /** @brief Returns true once cancel() was called. */
+        bool cancelled() const;
+
+        /** @brief Returns true if a deadline is set and has passed. */
+        bool deadline_passed() const;
+
+        /** @brief Returns true if the work should stop (cancelled or deadline passed). */
+        bool stop_requested() const;
+
+        /** @brief Throws Cancelled if the work should stop. */
+        void throw_if_stop_requested() const;
+
+    private:
+        std::atomic<bool> cancelled_;
+        std::atomic<Clock::rep> deadline_;   ///< Deadline in clock ticks, max() if none
+    };
+}
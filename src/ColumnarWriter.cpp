@@ -0,0 +1,114 @@
+#include "ColumnarWriter.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace ensiie
+{
+    namespace
+    {
+        const char magic[8] = { 'L', 'B', 'K', 'C', 'O', 'L', 'S', '\0' };
+
+        void store_u32(char* out, std::uint32_t v)
+        {
+            for (int i = 0; i < 4; ++i)
+                out[i] = static_cast<char>((v >> (8 * i)) & 0xff);
+        }
+
+        bool little_endian_host()
+        {
+            const std::uint32_t probe = 1;
+            char first;
+            std::memcpy(&first, &probe, 1);
+            return first == 1;
+        }
+    }
+
+    ColumnarWriter::ColumnarWriter()
+    {
+        buffer_.append(magic, sizeof(magic));
+        put_u32(version);
+        put_u32(0);
+    }
+
+    void ColumnarWriter::put_u32(std::uint32_t v)
+    {
+        char b[4];
+        store_u32(b, v);
+        buffer_.append(b, 4);
+    }
+
+    void ColumnarWriter::put_u64(std::uint64_t v)
+    {
+        char b[8];
+        for (int i = 0; i < 8; ++i)
+            b[i] = static_cast<char>((v >> (8 * i)) & 0xff);
+        buffer_.append(b, 8);
+    }
+
+    void ColumnarWriter::put_name(const std::string& name)
+    {
+        put_u32(static_cast<std::uint32_t>(name.size()));
+        buffer_.append(name);
+        pad();
+    }
+
+    void ColumnarWriter::pad()
+    {
+        while (buffer_.size() % 8 != 0)
+            buffer_.push_back('\0');
+    }
+
+    void ColumnarWriter::add_table(const std::string& name, const std::vector<std::string>& columnNames,
+        const std::vector<std::vector<double>>& columns)
+    {
+        if (columnNames.size() != columns.size())
+            throw std::invalid_argument("Columnar table needs one name per column.");
+
+        const std::size_t rows = columns.empty() ? 0 : columns.front().size();
+        for (const std::vector<double>& c : columns)
+            if (c.size() != rows)
+                throw std::invalid_argument("Columns of a table must have the same length.");
+
+        buffer_.reserve(buffer_.size() + 64 + columns.size() * (rows * sizeof(double) + 64));
+
+        put_name(name);
+        put_u32(static_cast<std::uint32_t>(columns.size()));
+        put_u32(0);
+        put_u64(rows);
+
+        for (std::size_t j = 0; j < columns.size(); ++j)
+        {
+            put_name(columnNames[j]);
+            put_u64(static_cast<std::uint64_t>(rows * sizeof(double)));
+
+            // IEEE 754 bit patterns in little-endian order: a plain copy on little-endian hosts
+            if (little_endian_host())
+            {
+                buffer_.append(reinterpret_cast<const char*>(columns[j].data()), rows * sizeof(double));
+                continue;
+            }
+
+            for (double v : columns[j])
+            {
+                std::uint64_t bits;
+                std::memcpy(&bits, &v, sizeof(bits));
+                put_u64(bits);
+            }
+        }
+
+        store_u32(&buffer_[12], ++tableCount_);
+    }
+
+    void ColumnarWriter::save(const std::string& path) const
+    {
+        std::FILE* f = std::fopen(path.c_str(), "wb");
+        if (!f)
+            throw std::runtime_error("Cannot open columnar output file: " + path);
+
+        // The whole file in one write
+        const bool ok = std::fwrite(buffer_.data(), 1, buffer_.size(), f) == buffer_.size();
+        if (std::fclose(f) != 0 || !ok)
+            throw std::runtime_error("Failed to write columnar output file: " + path);
+    }
+}
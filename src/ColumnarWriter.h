@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ensiie
+{
+    /**
+     * @brief Binary columnar output: tables of named double columns in one file.
+     *
+     * Layout (all integers little-endian, every block padded to 8 bytes):
+     *   - "LBKCOLS\0", uint32 version, uint32 table count;
+     *   - per table: uint32 name length, name, uint32 column count, uint32 0,
+     *     uint64 row count;
+     *   - per column: uint32 name length, name, uint64 byte length (8 x rows),
+     *     then the values as little-endian IEEE 754 doubles.
+     *
+     * Each column starts on an 8-byte boundary, so a reader can map the file and
+     * use the columns in place (e.g. numpy.frombuffer with an offset). Values keep
+     * full double precision.
+     */
+    class ColumnarWriter
+    {
+    public:
+        /** @brief Format version written in the header. */
+        static constexpr std::uint32_t version = 1;
+
+        /** @brief Constructor of a file without tables. */
+        ColumnarWriter();
+
+        /**
+         * @brief Adds a table.
+         * @param name Table name.
+         * @param columnNames Name of each column.
+         * @param columns Values of each column, all of the same length.
+         */
+        void add_table(const std::string& name, const std::vector<std::string>& columnNames,
+            const std::vector<std::vector<double>>& columns);
+
+        /** @brief Returns the encoded file (header included). */
+        const std::string& bytes() const { return buffer_; }
+
+        /**
+         * @brief Writes the file in a single write.
+         *
+         * Throws std::runtime_error if the file cannot be written.
+         */
+        void save(const std::string& path) const;
+
+    private:
+        std::uint32_t tableCount_ = 0;   ///< Tables added so far
+        std::string buffer_;             ///< Encoded file, header first
+
+        void put_u32(std::uint32_t v);
+        void put_u64(std::uint64_t v);
+        void put_name(const std::string& name);
+        void pad();
+    };
+}
@@ -0,0 +1,85 @@
+#include "CostModel.h"
+#include "Call.h"
+#include "Arena.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace ensiie
+{
+    CostModel::CostModel(double simulationSeconds, double evaluationSeconds)
+        : simulationSeconds_(simulationSeconds), evaluationSeconds_(evaluationSeconds)
+    {
+    }
+
+    const CostModel& CostModel::calibrated()
+    {
+        static const CostModel model = []()
+        {
+            using Clock = std::chrono::steady_clock;
+
+            // Quarter-year daily grid, 4 blocks of paths: large enough to amortize the
+            // setup, small enough to stay in cache like the inner loops of a real run
+            const int N = 4 * MonteCarlo::block_size;
+            double simulation = std::numeric_limits<double>::max();
+            double evaluation = std::numeric_limits<double>::max();
+
+            for (int rep = 0; rep < 3; ++rep)
+            {
+                in_thread_arena([&]()
+                    {
+                        const auto t0 = Clock::now();
+                        const Call option(0.0, 0.25, 100.0, 0.05, 0.2, N, 1.0, 1, 1);
+                        const auto t1 = Clock::now();
+                        const volatile double price = option.price();
+                        (void)price;
+                        const auto t2 = Clock::now();
+
+                        const double steps = static_cast<double>(N) * option.get_Nt();
+                        simulation = std::min(simulation, std::chrono::duration<double>(t1 - t0).count() / steps);
+                        evaluation = std::min(evaluation, std::chrono::duration<double>(t2 - t1).count() / steps);
+                    });
+            }
+
+            return CostModel(simulation, evaluation);
+        }();
+
+        return model;
+    }
+
+    double CostModel::path_set_bytes(const Workload& w)
+    {
+        // A path matrix (a seasoned trade only keeps its summaries), plus a double
+        // per path for each estimator buffer and the running values
+        const double valueBytes = (w.precision == Precision::Single) ? sizeof(float) : sizeof(double);
+        const double pathBytes = w.seasoned
+            ? static_cast<double>(w.N) * (5 * sizeof(double) + sizeof(char))
+            : static_cast<double>(w.N) * (w.Nt + 1) * valueBytes;
+        const double bufferBytes = 2.0 * w.N * sizeof(double);
+
+        return pathBytes + bufferBytes;
+    }
+
+    CostEstimate CostModel::estimate(const Workload& w, unsigned int workers) const
+    {
+        const double steps = static_cast<double>(w.N) * w.Nt;
+        const double simulation = steps * simulationSeconds_;
+        const double evaluation = steps * evaluationSeconds_;
+
+        // Total work over the workers, but never below the chain of dependent simulations
+        const double total = w.simulations * simulation + w.evaluations * evaluation;
+        const double seconds = std::max(total / std::max(1u, workers), w.serial_simulations * simulation);
+
+        return CostEstimate{ seconds, w.live_path_sets * path_set_bytes(w), w.simulations * steps };
+    }
+
+    double CostModel::simulation_seconds() const
+    {
+        return simulationSeconds_;
+    }
+
+    double CostModel::evaluation_seconds() const
+    {
+        return evaluationSeconds_;
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "MonteCarlo.h"
+
+namespace ensiie
+{
+    /**
+     * @brief Work of one request, counted in path sets of N paths x Nt steps.
+     *
+     * Filled by Interface for the selected mode, before anything is simulated.
+     */
+    struct Workload
+    {
+        int N = 0;                     ///< Paths per simulation
+        int Nt = 0;                    ///< Time steps per path
+        int simulations = 0;           ///< Simulations of N paths (base run, bumps, graph rows)
+        int evaluations = 0;           ///< Estimator passes over N paths (price, Greeks, rows)
+        int serial_simulations = 0;    ///< Simulations that must run one after the other (critical path)
+        int live_path_sets = 0;        ///< Path sets alive at the same time at the peak
+        Precision precision = Precision::Double;
+        bool seasoned = false;         ///< Paths summarized, no path matrix
+    };
+
+    /** @brief Predicted cost of a Workload. */
+    struct CostEstimate
+    {
+        double seconds;        ///< Wall time
+        double peak_bytes;     ///< Peak memory of the path sets and estimator buffers
+        double path_steps;     ///< Simulated path steps
+    };
+
+    /**
+     * @brief Predicts the wall time and peak memory of a request from its Workload.
+     *
+     * Time is linear in the simulated and evaluated path steps, with throughput
+     * constants measured on this host (calibrated()); memory is the path matrices
+     * alive at the peak (N x (Nt + 1) values each, or the per-path summaries of a
+     * seasoned trade) plus the per-path estimator buffers.
+     */
+    class CostModel
+    {
+    public:
+        /**
+         * @brief Constructor from throughput constants.
+         * @param simulationSeconds Seconds per simulated path step on one thread.
+         * @param evaluationSeconds Seconds per evaluated path step on one thread.
+         */
+        CostModel(double simulationSeconds, double evaluationSeconds);
+
+        /**
+         * @brief Model calibrated by a micro-benchmark on first use (a few milliseconds):
+         * one small simulation and one price evaluation, the fastest of a few repetitions.
+         */
+        static const CostModel& calibrated();
+
+        /**
+         * @brief Predicted cost of w on workers threads.
+         *
+         * Wall time is the larger of the critical path and the total work spread
+         * over the workers.
+         */
+        CostEstimate estimate(const Workload& w, unsigned int workers) const;
+
+        /** @brief Bytes of one live path set of w: its path matrix (or summaries) and estimator buffers. */
+        static double path_set_bytes(const Workload& w);
+
+        /** @brief Seconds per simulated path step on one thread. */
+        double simulation_seconds() const;
+
+        /** @brief Seconds per evaluated path step on one thread. */
+        double evaluation_seconds() const;
+
+    private:
+        double simulationSeconds_;
+        double evaluationSeconds_;
+    };
+}
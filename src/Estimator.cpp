@@ -0,0 +1,354 @@
+#include "Estimator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace ensiie
+{
+    namespace
+    {
+        const char* const stateMagic = "lookback-estimator-state";
+        const int stateVersion = 7;
+
+        /** @brief Reads the next token, throwing if the stream is exhausted. */
+        std::string next_token(std::istream& in)
+        {
+            std::string token;
+            if (!(in >> token))
+                throw std::runtime_error("Truncated estimator state file.");
+            return token;
+        }
+
+        /** @brief Reads "key value" and returns value, checking the key. */
+        std::string read_field(std::istream& in, const std::string& key)
+        {
+            if (next_token(in) != key)
+                throw std::runtime_error("Malformed estimator state file: expected '" + key + "'.");
+            return next_token(in);
+        }
+
+        /** @brief Parses a double written in decimal or hexadecimal form. */
+        double parse_double(const std::string& token)
+        {
+            char* end = nullptr;
+            const double value = std::strtod(token.c_str(), &end);
+            if (end == token.c_str() || *end != '\0')
+                throw std::runtime_error("Malformed number in estimator state file: " + token);
+            return value;
+        }
+
+        /** @brief Writes "key m T1 v1 ... Tm vm" (the stream is in hexfloat mode). */
+        void write_curve(std::ostream& out, const std::string& key, const TermStructure& curve)
+        {
+            out << key << " " << curve.get_times().size();
+            for (size_t j = 0; j < curve.get_times().size(); ++j)
+                out << " " << curve.get_times()[j] << " " << curve.get_values()[j];
+            out << "\n";
+        }
+
+        /** @brief Reads a term structure written by write_curve(). */
+        TermStructure read_curve(std::istream& in, const std::string& key)
+        {
+            const int m = std::stoi(read_field(in, key));
+            if (m < 0)
+                throw std::runtime_error("Malformed term structure in estimator state file.");
+
+            std::vector<double> times(m), values(m);
+            for (int j = 0; j < m; ++j)
+            {
+                times[j] = parse_double(next_token(in));
+                values[j] = parse_double(next_token(in));
+            }
+            return TermStructure(std::move(times), std::move(values));
+        }
+    }
+
+    double theta_step(double t, double T)
+    {
+        double eps_theta = 1.0 / 252.0;
+
+        // Check time bounds
+        if (t + eps_theta >= T)
+            eps_theta = (T - t) * 0.5;
+
+        return eps_theta;
+    }
+
+    ArenaVector<double> block_totals(const double* values, int count)
+    {
+        const int nBlocks = MonteCarlo::block_count(count);
+        ArenaVector<double> totals(nBlocks);
+
+        for (int b = 0; b < nBlocks; ++b)
+        {
+            const int first = b * MonteCarlo::block_size;
+            const int last = std::min(count, first + MonteCarlo::block_size);
+
+            totals[b] = block_sum(values + first, last - first);
+        }
+
+        return totals;
+    }
+
+    Moments sample_moments(const double* values, int count)
+    {
+        Moments m;
+        if (count <= 0)
+            return m;
+
+        m.count = static_cast<double>(count);
+        m.sum = block_sum(values, count);
+
+        const double mean = m.mean();
+        BlockAccumulator m2;
+        for (int i = 0; i < count; ++i)
+            m2.add((values[i] - mean) * (values[i] - mean));
+        m.m2 = m2.value();
+
+        return m;
+    }
+
+    ArenaVector<Moments> block_moments(const double* values, int count)
+    {
+        const int nBlocks = MonteCarlo::block_count(count);
+        ArenaVector<Moments> moments(nBlocks);
+
+        for (int b = 0; b < nBlocks; ++b)
+        {
+            const int first = b * MonteCarlo::block_size;
+            const int last = std::min(count, first + MonteCarlo::block_size);
+
+            moments[b] = sample_moments(values + first, last - first);
+        }
+
+        return moments;
+    }
+
+    EstimatorState::EstimatorState(OptionType type, double t, double T, double S0, double r, double sigma,
+        int N, unsigned long seed, const SimulationSettings& settings)
+        : type_(type), t_(t), T_(T), S0_(S0), r_(r), sigma_(sigma), N_(N), seed_(seed),
+        precision_(settings.precision), sampling_(settings.sampling),
+        strata_(settings.sampling == Sampling::Stratified ? settings.strata : 1), driftShift_(settings.drift_shift),
+        rateCurve_(settings.rate_curve), volCurve_(settings.vol_curve), fixings_(settings.fixing_dates),
+        runningExtreme_(settings.running_extreme),
+        blocks_(MonteCarlo::block_count(N)), present_(MonteCarlo::block_count(N), 0)
+    {
+    }
+
+    void EstimatorState::set_block(int b, const BlockSums& sums)
+    {
+        if (b < 0 || b >= static_cast<int>(blocks_.size()))
+            throw std::out_of_range("Block index out of range.");
+
+        if (present_[b])
+            throw std::invalid_argument("Block " + std::to_string(b) + " is already present.");
+
+        blocks_[b] = sums;
+        present_[b] = 1;
+    }
+
+    bool EstimatorState::same_run(const EstimatorState& other) const
+    {
+        return type_ == other.type_ && t_ == other.t_ && T_ == other.T_ && S0_ == other.S0_
+            && r_ == other.r_ && sigma_ == other.sigma_ && N_ == other.N_
+            && seed_ == other.seed_ && precision_ == other.precision_
+            && sampling_ == other.sampling_ && strata_ == other.strata_ && driftShift_ == other.driftShift_
+            && rateCurve_ == other.rateCurve_ && volCurve_ == other.volCurve_ && fixings_ == other.fixings_
+            && (runningExtreme_ == other.runningExtreme_
+                || (std::isnan(runningExtreme_) && std::isnan(other.runningExtreme_)));
+    }
+
+    void EstimatorState::merge(const EstimatorState& other)
+    {
+        if (!same_run(other))
+            throw std::invalid_argument("Cannot merge estimator states of different runs.");
+
+        for (size_t b = 0; b < blocks_.size(); ++b)
+        {
+            if (!other.present_[b])
+                continue;
+
+            if (present_[b])
+                throw std::invalid_argument("Block " + std::to_string(b) + " is present in two shards.");
+
+            blocks_[b] = other.blocks_[b];
+            present_[b] = 1;
+        }
+    }
+
+    bool EstimatorState::complete() const
+    {
+        return std::all_of(present_.begin(), present_.end(), [](char p) { return p != 0; });
+    }
+
+    EstimatorResult EstimatorState::finalize() const
+    {
+        if (!complete())
+            throw std::runtime_error("Estimator state is missing blocks: merge every shard first.");
+
+        return estimate();
+    }
+
+    EstimatorResult EstimatorState::estimate() const
+    {
+        std::vector<int> present;
+        for (size_t b = 0; b < blocks_.size(); ++b)
+            if (present_[b])
+                present.push_back(static_cast<int>(b));
+
+        if (present.empty())
+            throw std::runtime_error("Estimator state has no block.");
+
+        // Same expressions as Pricing, so a complete state is bit-identical to a single run
+        const int nBlocks = static_cast<int>(present.size());
+        auto fold = [&](double BlockSums::* field)
+        {
+            return fold_blocks(nBlocks, [&](int j) { return blocks_[present[j]].*field; });
+        };
+
+        // Counts are integers: their sum is exact, and equals N once complete
+        const Moments payoff = fold_moments(nBlocks, [&](int j)
+            {
+                const BlockSums& s = blocks_[present[j]];
+                return Moments{ s.count, s.payoff, s.payoff_m2 };
+            });
+        const double n = payoff.count;
+
+        const double discount = discount_factor(r_, rateCurve_, t_, T_);
+
+        EstimatorResult res;
+        res.paths = n;
+        res.price = discount * payoff.mean();
+        res.payoff_stderr = payoff.std_error();
+        res.price_stderr = discount * res.payoff_stderr;
+        res.delta = discount * (fold(&BlockSums::payoff_delta) / n) / S0_;
+        res.gamma = discount * (fold(&BlockSums::gamma) / n);
+        res.vega = discount * (fold(&BlockSums::vega) / n);
+
+        const double eps_theta = theta_step(t_, T_);
+        const double tForward = t_ + eps_theta;
+        const double forward = discount_factor(r_, rateCurve_, tForward, T_) * (fold(&BlockSums::payoff_theta) / n);
+        res.theta = (forward - res.price) / eps_theta;
+
+        const double rUp = r_ + rho_step;
+        const double up = discount_factor(rUp, rateCurve_.shifted(rho_step), t_, T_) * (fold(&BlockSums::payoff_rho) / n);
+        res.rho = (up - res.price) / rho_step;
+
+        return res;
+    }
+
+    void EstimatorState::save(const std::string& path) const
+    {
+        std::ofstream out(path);
+        if (!out)
+            throw std::runtime_error("Cannot open estimator state file for writing: " + path);
+
+        out << stateMagic << " " << stateVersion << "\n"
+            << "block_size " << MonteCarlo::block_size << "\n"
+            << "type " << (type_ == OptionType::Call ? "call" : "put") << "\n"
+            << std::hexfloat
+            << "t " << t_ << "\n"
+            << "T " << T_ << "\n"
+            << "S0 " << S0_ << "\n"
+            << "r " << r_ << "\n"
+            << "sigma " << sigma_ << "\n"
+            << "N " << N_ << "\n"
+            << "seed " << seed_ << "\n"
+            << "precision " << (precision_ == Precision::Single ? "single" : "double") << "\n"
+            << "sampling " << (sampling_ == Sampling::Stratified ? "stratified" : "antithetic") << "\n"
+            << "strata " << strata_ << "\n"
+            << "drift_shift " << driftShift_ << "\n";
+        write_curve(out, "rate_curve", rateCurve_);
+        write_curve(out, "vol_curve", volCurve_);
+
+        out << "fixings " << fixings_.size();
+        for (double d : fixings_)
+            out << " " << d;
+        out << "\n"
+            << "running_extreme " << runningExtreme_ << "\n";
+
+        const long long nPresent = std::count(present_.begin(), present_.end(), 1);
+        out << "blocks " << nPresent << "\n";
+
+        for (size_t b = 0; b < blocks_.size(); ++b)
+        {
+            if (!present_[b])
+                continue;
+
+            const BlockSums& s = blocks_[b];
+            out << b << " " << s.count << " " << s.payoff << " " << s.payoff_m2 << " " << s.payoff_delta << " "
+                << s.gamma << " " << s.vega << " " << s.payoff_theta << " " << s.payoff_rho << "\n";
+        }
+
+        if (!out)
+            throw std::runtime_error("Failed to write estimator state file: " + path);
+    }
+
+    EstimatorState EstimatorState::load(const std::string& path)
+    {
+        std::ifstream in(path);
+        if (!in)
+            throw std::runtime_error("Cannot open estimator state file: " + path);
+
+        if (next_token(in) != stateMagic || std::stoi(next_token(in)) != stateVersion)
+            throw std::runtime_error("Not an estimator state file (or unsupported version): " + path);
+
+        if (std::stoi(read_field(in, "block_size")) != MonteCarlo::block_size)
+            throw std::runtime_error("Estimator state written with a different block size: " + path);
+
+        const std::string type = read_field(in, "type");
+        const double t = parse_double(read_field(in, "t"));
+        const double T = parse_double(read_field(in, "T"));
+        const double S0 = parse_double(read_field(in, "S0"));
+        const double r = parse_double(read_field(in, "r"));
+        const double sigma = parse_double(read_field(in, "sigma"));
+        const int N = std::stoi(read_field(in, "N"));
+        const unsigned long seed = std::stoul(read_field(in, "seed"));
+        const std::string precision = read_field(in, "precision");
+        const std::string sampling = read_field(in, "sampling");
+
+        SimulationSettings settings;
+        settings.strata = std::stoi(read_field(in, "strata"));
+        settings.drift_shift = parse_double(read_field(in, "drift_shift"));
+        settings.rate_curve = read_curve(in, "rate_curve");
+        settings.vol_curve = read_curve(in, "vol_curve");
+
+        const int nFixings = std::stoi(read_field(in, "fixings"));
+        if (nFixings < 0)
+            throw std::runtime_error("Malformed fixing schedule in estimator state file: " + path);
+        for (int j = 0; j < nFixings; ++j)
+            settings.fixing_dates.push_back(parse_double(next_token(in)));
+        settings.running_extreme = parse_double(read_field(in, "running_extreme"));
+
+        if (N <= 0 || (type != "call" && type != "put") || (precision != "double" && precision != "single")
+            || (sampling != "antithetic" && sampling != "stratified") || settings.strata < 1)
+            throw std::runtime_error("Malformed estimator state header: " + path);
+
+        settings.precision = (precision == "single") ? Precision::Single : Precision::Double;
+        settings.sampling = (sampling == "stratified") ? Sampling::Stratified : Sampling::Antithetic;
+
+        EstimatorState state(type == "call" ? OptionType::Call : OptionType::Put, t, T, S0, r, sigma, N, seed,
+            settings);
+
+        const long long nPresent = std::stoll(read_field(in, "blocks"));
+        for (long long j = 0; j < nPresent; ++j)
+        {
+            const int b = std::stoi(next_token(in));
+            BlockSums s;
+            s.count = parse_double(next_token(in));
+            s.payoff = parse_double(next_token(in));
+            s.payoff_m2 = parse_double(next_token(in));
+            s.payoff_delta = parse_double(next_token(in));
+            s.gamma = parse_double(next_token(in));
+            s.vega = parse_double(next_token(in));
+            s.payoff_theta = parse_double(next_token(in));
+            s.payoff_rho = parse_double(next_token(in));
+            state.set_block(b, s);
+        }
+
+        return state;
+    }
+}
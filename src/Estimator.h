@@ -0,0 +1,298 @@
+#pragma once
+#include "MonteCarlo.h"
+#include "Summation.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace ensiie
+{
+    /**
+     * @brief Partial sums of the estimators over one block of paths.
+     *
+     * Price, Delta, Gamma, Vega, Theta and Rho are all linear in these sums, so a run
+     * is fully described by the sums of its blocks; the payoff variance comes from
+     * the centered sums, merged as in merge_moments().
+     */
+    struct BlockSums
+    {
+        double count = 0.0;          ///< Number of paths in the block
+        double payoff = 0.0;         ///< Sum of payoffs
+        double payoff_m2 = 0.0;      ///< Sum of squared deviations from the block's mean payoff
+        double payoff_delta = 0.0;   ///< Sum of S0 x pathwise deltas (the payoffs for a fresh trade)
+        double gamma = 0.0;          ///< Sum of per-path gammas (0 for a fresh trade)
+        double vega = 0.0;           ///< Sum of pathwise vegas
+        double payoff_theta = 0.0;   ///< Sum of payoffs with t bumped by theta_step()
+        double payoff_rho = 0.0;     ///< Sum of payoffs with r bumped by rho_step
+    };
+
+    /** @brief Estimates obtained from the blocks of an EstimatorState. */
+    struct EstimatorResult
+    {
+        double paths;           ///< Number of paths behind the estimates
+        double price;
+        double payoff_stderr;   ///< Standard error of the undiscounted payoff mean
+        double price_stderr;    ///< Standard error of the price
+        double delta;
+        double gamma;
+        double theta;
+        double rho;
+        double vega;
+    };
+
+    /** @brief Rate bump of the Rho forward finite difference. */
+    constexpr double rho_step = 0.0001;
+
+    /** @brief Time bump of the Theta forward finite difference (one day, or half the remaining life). */
+    double theta_step(double t, double T);
+
+    /**
+     * @brief Sums values[0..count) block by block (MonteCarlo::block_size values per block).
+     * @return One compensated total per block (block_sum()).
+     */
+    ArenaVector<double> block_totals(const double* values, int count);
+
+    /**
+     * @brief Sum of per-block totals by a fixed pairwise tree over the block indices.
+     *
+     * Used by a single run, a merge of shards and the batched engine, so they all
+     * give bit-identical estimates: the blocks are fixed by N, not by the threads
+     * or chunks that computed them.
+     * @param nBlocks Number of blocks.
+     * @param total Callable returning the total of block b.
+     */
+    template <class F>
+    double fold_blocks(int nBlocks, F&& total)
+    {
+        return pairwise_sum(0, nBlocks, total);
+    }
+
+    /**
+     * @brief Count, sum and centered sum of squares (M2) of a set of path values.
+     *
+     * Mergeable like a plain sum, but the variance comes from M2 instead of
+     * sum(x^2) - n mean^2, which cancels catastrophically when the mean is large
+     * against the spread.
+     */
+    struct Moments
+    {
+        double count = 0.0;
+        double sum = 0.0;
+        double m2 = 0.0;
+
+        /** @brief Mean of the values. */
+        double mean() const { return sum / count; }
+
+        /** @brief Unbiased variance (0 for fewer than two values). */
+        double variance() const { return (count < 2.0) ? 0.0 : m2 / (count - 1.0); }
+
+        /** @brief Standard error of the mean (0 for fewer than two values). */
+        double std_error() const { return std::sqrt(variance()) / std::sqrt(count); }
+    };
+
+    /**
+     * @brief Moments of values[0..count): sum by block_sum(), then M2 by block_sum()
+     * of the squared deviations from that mean (two passes over the values).
+     */
+    Moments sample_moments(const double* values, int count);
+
+    /** @brief Moments of values[0..count) block by block (MonteCarlo::block_size values per block). */
+    ArenaVector<Moments> block_moments(const double* values, int count);
+
+    /** @brief Chan et al. merge of the moments of two disjoint sets of values. */
+    inline Moments merge_moments(const Moments& a, const Moments& b)
+    {
+        if (a.count == 0.0)
+            return b;
+        if (b.count == 0.0)
+            return a;
+
+        Moments m;
+        m.count = a.count + b.count;
+        m.sum = a.sum + b.sum;
+        const double delta = b.mean() - a.mean();
+        m.m2 = a.m2 + b.m2 + delta * delta * (a.count * b.count / m.count);
+        return m;
+    }
+
+    /**
+     * @brief Per-block moments merged by the fixed pairwise tree of fold_blocks().
+     *
+     * The sum is therefore bit-identical to fold_blocks() on the block sums, and the
+     * merged M2 is equally independent of the threads, chunks or shards involved.
+     * @param nBlocks Number of blocks.
+     * @param moments Callable returning the Moments of block b.
+     */
+    template <class F>
+    Moments fold_moments(int nBlocks, F&& moments)
+    {
+        return pairwise_reduce<Moments>(0, nBlocks, moments, merge_moments);
+    }
+
+    /**
+     * @brief Streaming sum over the paths of a run, one value per path in path order.
+     *
+     * Each block of MonteCarlo::block_size paths goes through a BlockAccumulator and
+     * the block totals are folded by fold_blocks(): the result is bit-identical to
+     * block_totals() and fold_blocks() on the stored values, for engines that compute
+     * their per-path values on the fly.
+     */
+    class PathSum
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param paths Number of paths that will be added: the block totals are
+         * reserved up front, so an arena never keeps outgrown buffers.
+         */
+        explicit PathSum(int paths = 0) { totals_.reserve(MonteCarlo::block_count(paths)); }
+
+        /** @brief Adds the value of the next path. */
+        void add(double x)
+        {
+            block_.add(x);
+            if (++count_ == MonteCarlo::block_size)
+            {
+                totals_.push_back(block_.value());
+                block_ = BlockAccumulator();
+                count_ = 0;
+            }
+        }
+
+        /** @brief Returns the sum over the paths added so far. */
+        double value() const
+        {
+            const int nBlocks = static_cast<int>(totals_.size());
+            return fold_blocks(nBlocks + (count_ > 0 ? 1 : 0),
+                [&](int b) { return b < nBlocks ? totals_[b] : block_.value(); });
+        }
+
+    private:
+        ArenaVector<double> totals_;   ///< Totals of the complete blocks
+        BlockAccumulator block_;       ///< Current block
+        int count_ = 0;                ///< Paths in the current block
+    };
+
+    /**
+     * @brief Streaming Moments over the paths of a run, one value per path in path order.
+     *
+     * The values of the current block are kept until it is complete, then reduced
+     * by sample_moments(): the result is bit-identical to block_moments() and
+     * fold_moments() on the stored values, and its sum to PathSum.
+     */
+    class PathMoments
+    {
+    public:
+        /** @param paths Number of paths that will be added (reserved up front, as PathSum). */
+        explicit PathMoments(int paths = 0)
+        {
+            moments_.reserve(MonteCarlo::block_count(paths));
+            block_.reserve(MonteCarlo::block_size);
+        }
+
+        /** @brief Adds the value of the next path. */
+        void add(double x)
+        {
+            block_.push_back(x);
+            if (static_cast<int>(block_.size()) == MonteCarlo::block_size)
+            {
+                moments_.push_back(sample_moments(block_.data(), MonteCarlo::block_size));
+                block_.clear();
+            }
+        }
+
+        /** @brief Returns the moments of the paths added so far. */
+        Moments value() const
+        {
+            const int nBlocks = static_cast<int>(moments_.size());
+            const Moments last = sample_moments(block_.data(), static_cast<int>(block_.size()));
+            return fold_moments(nBlocks + (block_.empty() ? 0 : 1),
+                [&](int b) { return b < nBlocks ? moments_[b] : last; });
+        }
+
+    private:
+        ArenaVector<Moments> moments_;   ///< Moments of the complete blocks
+        ArenaVector<double> block_;      ///< Values of the current block
+    };
+
+    /**
+     * @brief Serializable, mergeable estimator state of a (sharded) run.
+     *
+     * Holds the BlockSums of every block of the path index space of one run
+     * (same option, market parameters and curves, fixing schedule, carried-in
+     * extreme, N, seed, precision and sampling scheme). Shards fill
+     * disjoint slices of blocks; once all blocks are present, finalize()
+     * returns exactly the estimates of the unsharded run.
+     */
+    class EstimatorState
+    {
+    public:
+        /**
+         * @brief Constructor of an empty state (no block present).
+         *
+         * @param type Option type.
+         * @param t Initial time.
+         * @param T Maturity time.
+         * @param S0 Spot price.
+         * @param r Risk-free interest rate.
+         * @param sigma Volatility.
+         * @param N Number of Monte Carlo Simulations of the whole run.
+         * @param seed Seed of the run.
+         * @param settings Simulation settings of the run (precision, sampling scheme, term
+         * structures, fixing schedule and running extreme are recorded; the shard and
+         * block fields are ignored).
+         */
+        EstimatorState(OptionType type, double t, double T, double S0, double r, double sigma,
+            int N, unsigned long seed, const SimulationSettings& settings);
+
+        /** @brief Stores the sums of block b. Throws std::invalid_argument if b is already present. */
+        void set_block(int b, const BlockSums& sums);
+
+        /**
+         * @brief Adds the blocks of another shard of the same run.
+         *
+         * Throws std::invalid_argument if the runs differ or a block is present in both.
+         */
+        void merge(const EstimatorState& other);
+
+        /** @brief Returns true once every block of the run is present. */
+        bool complete() const;
+
+        /** @brief Estimates of the full run. Throws std::runtime_error if blocks are missing. */
+        EstimatorResult finalize() const;
+
+        /**
+         * @brief Running estimates from the blocks present so far.
+         *
+         * Equal to finalize() once the state is complete. Throws std::runtime_error
+         * if no block is present.
+         */
+        EstimatorResult estimate() const;
+
+        /** @brief Writes the state to a text file (doubles in exact hexadecimal form). */
+        void save(const std::string& path) const;
+
+        /** @brief Reads a state written by save(). */
+        static EstimatorState load(const std::string& path);
+
+    private:
+        OptionType type_;
+        double t_, T_, S0_, r_, sigma_;
+        int N_;
+        unsigned long seed_;
+        Precision precision_;
+        Sampling sampling_;
+        int strata_;
+        double driftShift_;
+        TermStructure rateCurve_;
+        TermStructure volCurve_;
+        std::vector<double> fixings_;
+        double runningExtreme_;
+
+        std::vector<BlockSums> blocks_;   ///< Sums of every block of the run
+        std::vector<char> present_;       ///< 1 if the block has been set
+
+        /** @brief Returns true if both states describe the same run. */
+        bool same_run(const EstimatorState& other) const;
+    };
+}
@@ -1,16 +1,32 @@
 #include "Interface.h"
-#include "call.h"
+#include "Call.h"
 #include "put.h"
+#include "Parallel.h"
+#include "Richardson.h"
+#include "AllocationStats.h"
+#include "ColumnarWriter.h"
+#include "Numa.h"
+#include "Cancellation.h"
+#include "CostModel.h"
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <stdexcept>
 #include <memory>
 #include <algorithm>
+#include <cmath>
 
 namespace ensiie
 {
+    namespace
+    {
+        /** @brief Memory budget of the path sets of an Excel run without --max-memory. */
+        const double default_path_budget_mb = 2048.0;
+    }
+
     // Constructor calling the argument parser
-    Interface::Interface(int argc, char* argv[])
+    Interface::Interface(int argc, char* argv[], std::ostream& out)
+        : out_(out)
     {
         parse_arguments(argc, argv);
     }
@@ -18,6 +34,21 @@ namespace ensiie
     // Convert command line strings into numeric 
     void Interface::parse_arguments(int argc, char* argv[])
     {
+        // Merge subcommand: pricer merge file1 file2 ...
+        if (argc >= 2 && std::string(argv[1]) == "merge") {
+            if (argc < 3)
+                throw std::runtime_error("merge needs at least one estimator state file.");
+
+            mode_ = Mode::Merge;
+            args_.mergeFiles.assign(argv + 2, argv + argc);
+
+            // Merging simulates nothing: no option applies
+            for (const std::string& file : args_.mergeFiles)
+                if (file.rfind("--", 0) == 0)
+                    throw std::invalid_argument("merge only takes estimator state files, not " + file + ".");
+            return;
+        }
+
         // Check for 12  arguments 
         if (argc < 11) {
             throw std::runtime_error("Insufficient arguments provided by Excel.");
@@ -34,55 +65,492 @@ namespace ensiie
         args_.dS = std::stod(argv[8]);
         args_.M = std::stoi(argv[9]);
         args_.seed = std::stoul(argv[10]);
+
+        // Optional settings, not sent by the Excel sheet; anything else after the seed is a typo
+        for (int i = 11; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option.rfind("--", 0) != 0)
+                throw std::invalid_argument("Unexpected argument after the seed: " + option
+                    + " (options are --key=value).");
+            parse_option(option);
+        }
+
+        if (args_.settings.shard_count > 1 || !args_.stateFile.empty()) {
+            if (args_.stateFile.empty())
+                throw std::invalid_argument("A sharded run needs --state=file.");
+            if (mode_ != Mode::Excel)
+                throw std::invalid_argument(modeOption_ + " cannot be combined with a sharded run.");
+            mode_ = Mode::Shard;
+        }
+
+        check_options();
+    }
+
+    void Interface::select_mode(Mode mode, const std::string& option)
+    {
+        if (mode_ != Mode::Excel && mode_ != mode)
+            throw std::invalid_argument(option + " cannot be combined with " + modeOption_ + ".");
+        mode_ = mode;
+        modeOption_ = option;
+    }
+
+    void Interface::check_options() const
+    {
+        auto given = [&](const char* key) { return options_.count(key) > 0; };
+
+        if (given("refinement") && mode_ != Mode::Richardson)
+            throw std::invalid_argument("--refinement only applies to --richardson.");
+
+        if (given("strata") && args_.settings.sampling != Sampling::Stratified)
+            throw std::invalid_argument("--strata only applies to --sampling=stratified.");
+
+        if (given("admission") && !given("max-seconds") && !given("max-memory"))
+            throw std::invalid_argument("--admission only applies with --max-seconds or --max-memory.");
+
+        if (given("binary") && mode_ != Mode::Excel)
+            throw std::invalid_argument("--binary only applies to the pricing line and graph rows.");
+
+        // A dry run stops before simulating: run options would have no effect
+        if (args_.dryRun) {
+            for (const char* key : { "deadline", "binary", "normal-store", "alloc-stats", "numa-stats" })
+                if (given(key))
+                    throw std::invalid_argument(std::string("--") + key + " has no effect with --dry-run.");
+        }
+    }
+
+    void Interface::parse_option(const std::string& option)
+    {
+        const size_t eq = option.find('=');
+        const std::string key = option.substr(2, eq == std::string::npos ? std::string::npos : eq - 2);
+        const std::string value = (eq == std::string::npos) ? "" : option.substr(eq + 1);
+        options_.insert(key);
+
+        if (key == "precision") {
+            if (value == "double")
+                args_.settings.precision = Precision::Double;
+            else if (value == "single")
+                args_.settings.precision = Precision::Single;
+            else
+                throw std::invalid_argument("Precision must be 'double' or 'single'.");
+        }
+        else if (key == "shard") {
+            // --shard=i/n
+            const size_t slash = value.find('/');
+            if (slash == std::string::npos)
+                throw std::invalid_argument("Shard must be given as i/n.");
+            args_.settings.shard_index = std::stoi(value.substr(0, slash));
+            args_.settings.shard_count = std::stoi(value.substr(slash + 1));
+        }
+        else if (key == "state") {
+            args_.stateFile = value;
+        }
+        else if (key == "sampling") {
+            if (value == "antithetic")
+                args_.settings.sampling = Sampling::Antithetic;
+            else if (value == "stratified")
+                args_.settings.sampling = Sampling::Stratified;
+            else
+                throw std::invalid_argument("Sampling must be 'antithetic' or 'stratified'.");
+        }
+        else if (key == "strata") {
+            args_.settings.strata = std::stoi(value);
+        }
+        else if (key == "drift-shift") {
+            args_.settings.drift_shift = std::stod(value);
+        }
+        else if (key == "rate-curve") {
+            args_.settings.rate_curve = TermStructure::parse(value);
+        }
+        else if (key == "vol-curve") {
+            args_.settings.vol_curve = TermStructure::parse(value);
+        }
+        else if (key == "fixings") {
+            // --fixings=d1,d2,...
+            args_.settings.fixing_dates.clear();
+            size_t begin = 0;
+            while (begin < value.size()) {
+                size_t end = value.find(',', begin);
+                if (end == std::string::npos)
+                    end = value.size();
+                args_.settings.fixing_dates.push_back(std::stod(value.substr(begin, end - begin)));
+                begin = end + 1;
+            }
+        }
+        else if (key == "fixings-per-year") {
+            args_.settings.fixing_dates = MonteCarlo::regular_fixings(args_.t, args_.T, std::stod(value));
+        }
+        else if (key == "running-extreme") {
+            args_.settings.running_extreme = std::stod(value);
+        }
+        else if (key == "richardson") {
+            args_.richardsonPerYear = std::stod(value);
+            if (!(args_.richardsonPerYear > 0.0))
+                throw std::invalid_argument("Richardson steps per year must be positive.");
+            select_mode(Mode::Richardson, "--richardson");
+        }
+        else if (key == "refinement") {
+            args_.refinement = std::stoi(value);
+        }
+        else if (key == "progressive") {
+            select_mode(Mode::Progressive, "--progressive");
+        }
+        else if (key == "binary") {
+            if (value.empty())
+                throw std::invalid_argument("--binary needs an output file.");
+            args_.binaryFile = value;
+        }
+        else if (key == "second-order") {
+            select_mode(Mode::SecondOrder, "--second-order");
+        }
+        else if (key == "alloc-stats") {
+            if (!allocation_counting_enabled())
+                throw std::invalid_argument("--alloc-stats needs a build with -DLOOKBACK_ALLOC_STATS.");
+            allocStats_ = true;
+        }
+        else if (key == "numa-stats") {
+            numaStats_ = true;
+        }
+        else if (key == "normal-store") {
+            if (value.empty())
+                throw std::invalid_argument("--normal-store needs a directory.");
+            args_.settings.normal_store = value;
+        }
+        else if (key == "deadline") {
+            args_.deadline = std::stod(value);
+            if (!(args_.deadline > 0.0))
+                throw std::invalid_argument("Deadline must be a positive number of seconds.");
+        }
+        else if (key == "dry-run") {
+            args_.dryRun = true;
+        }
+        else if (key == "max-seconds") {
+            args_.maxSeconds = std::stod(value);
+            if (!(args_.maxSeconds > 0.0))
+                throw std::invalid_argument("--max-seconds must be positive.");
+        }
+        else if (key == "max-memory") {
+            args_.maxMemoryMB = std::stod(value);
+            if (!(args_.maxMemoryMB > 0.0))
+                throw std::invalid_argument("--max-memory must be a positive number of MB.");
+        }
+        else if (key == "admission") {
+            if (value == "reject")
+                args_.downscale = false;
+            else if (value == "downscale")
+                args_.downscale = true;
+            else
+                throw std::invalid_argument("Admission must be 'reject' or 'downscale'.");
+        }
+        else {
+            throw std::invalid_argument("Unknown option: " + option);
+        }
     }
 
     
     void Interface::run()
     {
         // Optimization: disable C-stream synchronization for faster output
-        std::ios_base::sync_with_stdio(false);
-        std::cin.tie(NULL);
+        // (only for the process streams: a server request writes to its own buffer)
+        if (&out_ == &std::cout) {
+            std::ios_base::sync_with_stdio(false);
+            std::cin.tie(NULL);
+        }
 
         // Set fixed decimal precision for financial results
-        std::cout << std::fixed << std::setprecision(6);
+        out_ << std::fixed << std::setprecision(6);
+
+        // Cost checked before anything is simulated; a dry run stops there
+        if (mode_ != Mode::Merge && (args_.dryRun || args_.maxSeconds > 0.0 || args_.maxMemoryMB > 0.0)) {
+            if (!admit())
+                return;
+        }
+
+        const AllocationStats before = allocation_stats();
+
+        // Every object of the request polls the same token, bumped runs included
+        if (args_.deadline > 0.0) {
+            if (!cancellation_)
+                cancellation_ = std::make_shared<CancellationToken>();
+            cancellation_->set_timeout(args_.deadline);
+        }
+        args_.settings.cancellation = cancellation_;
+
+        if (mode_ == Mode::Merge)
+            run_merge_mode();
+        else if (mode_ == Mode::Shard)
+            run_shard_mode();
+        else if (mode_ == Mode::Progressive)
+            run_progressive_mode();
+        else if (mode_ == Mode::Richardson)
+            run_richardson_mode();
+        else if (mode_ == Mode::SecondOrder)
+            run_second_order_mode();
+        else
+            run_excel_mode();
+
+        // Instrumentation on stderr: the Excel sheet only reads stdout
+        if (allocStats_) {
+            const AllocationStats used = allocation_stats() - before;
+            std::cerr << "Allocations: " << used.allocations
+                << ";Bytes: " << used.bytes
+                << ";ArenaChunks: " << requestArena_.chunk_allocations() << "\n";
+        }
+        if (numaStats_) {
+            const std::vector<NodeStats> stats = node_stats();
+            for (size_t n = 0; n < stats.size(); ++n) {
+                const double throughput = stats[n].seconds > 0.0 ? stats[n].path_steps / stats[n].seconds : 0.0;
+                std::cerr << "Node: " << n
+                    << ";PathSteps: " << stats[n].path_steps
+                    << ";Seconds: " << stats[n].seconds
+                    << ";StepsPerSecond: " << throughput << "\n";
+            }
+        }
+    }
+
+    Workload Interface::workload() const
+    {
+        Workload w;
+        w.N = args_.N;
+        w.Nt = MonteCarlo::step_count(args_.t, args_.T, args_.settings.fixing_dates);
+        w.precision = args_.settings.precision;
+        w.seasoned = !std::isnan(args_.settings.running_extreme);
+
+        const unsigned int workers = worker_count();
+
+        if (mode_ == Mode::Excel) {
+            // Price and Greeks on the base run, Theta and Rho bumps, one run per graph row
+            const int rows = args_.M + 1;
+            w.simulations = 3 + rows;
+            w.evaluations = 8 + 2 * rows;
+            w.serial_simulations = 2;
+            // Only the bumps and the rows simulate, as many at once as the budget allows
+            const int running = static_cast<int>(std::min<unsigned int>(workers, 2 + rows));
+            w.live_path_sets = 1 + std::min(running, path_set_slots(w));
+        }
+        else if (mode_ == Mode::Shard || mode_ == Mode::Progressive) {
+            // Estimator state: base run and both bumps, seven sums, on one thread
+            if (mode_ == Mode::Shard)
+                w.N = (args_.N + args_.settings.shard_count - 1) / args_.settings.shard_count;
+            w.simulations = 3;
+            w.evaluations = 7;
+            w.serial_simulations = 3;
+            w.live_path_sets = 3;
+        }
+        else if (mode_ == Mode::Richardson) {
+            // One simulation on the fine grid
+            w.Nt = std::max(1, static_cast<int>(std::lround((args_.T - args_.t) * args_.richardsonPerYear))) * args_.refinement;
+            w.simulations = 1;
+            w.evaluations = 3;
+            w.serial_simulations = 1;
+            w.live_path_sets = 1;
+        }
+        else if (mode_ == Mode::SecondOrder) {
+            w.simulations = 1;
+            w.evaluations = 6;
+            w.serial_simulations = 1;
+            w.live_path_sets = 1;
+        }
+
+        return w;
+    }
+
+    int Interface::path_set_slots(const Workload& w) const
+    {
+        const double budgetMB = (args_.maxMemoryMB > 0.0) ? args_.maxMemoryMB : default_path_budget_mb;
+        const double sets = budgetMB * 1024.0 * 1024.0 / CostModel::path_set_bytes(w);
+
+        // The base run stays alive for the whole request
+        return std::max(1, static_cast<int>(std::min(sets, 1e6)) - 1);
+    }
+
+    bool Interface::admit()
+    {
+        const CostModel& model = CostModel::calibrated();
+        const unsigned int workers = worker_count();
+        const double maxBytes = args_.maxMemoryMB * 1024.0 * 1024.0;
+
+        auto fits = [&](const CostEstimate& cost) {
+            return (args_.maxSeconds <= 0.0 || cost.seconds <= args_.maxSeconds)
+                && (maxBytes <= 0.0 || cost.peak_bytes <= maxBytes);
+        };
+
+        Workload w = workload();
+        CostEstimate cost = model.estimate(w, workers);
+        std::string decision = "accept";
+
+        if (!fits(cost)) {
+            // Cost is linear in N: scale it down to the limits, in whole blocks
+            // (multiples of the strata, or antithetic pairs, for small runs).
+            // Shards keep N, or their states would not merge.
+            double scale = 1.0;
+            if (args_.maxSeconds > 0.0)
+                scale = std::min(scale, args_.maxSeconds / cost.seconds);
+            if (maxBytes > 0.0)
+                scale = std::min(scale, maxBytes / cost.peak_bytes);
+
+            const int unit = (args_.settings.sampling == Sampling::Stratified) ? args_.settings.strata : 2;
+            int N = static_cast<int>(args_.N * scale);
+            N = (N >= MonteCarlo::block_size) ? N - N % MonteCarlo::block_size : std::max(unit, N - N % unit);
+
+            Workload scaled = w;
+            scaled.N = (mode_ == Mode::Shard) ? w.N : N;
+            const CostEstimate scaledCost = model.estimate(scaled, workers);
+
+            if (args_.downscale && mode_ != Mode::Shard && N < args_.N && fits(scaledCost)) {
+                decision = "downscale";
+                w = scaled;
+                cost = scaledCost;
+            }
+            else {
+                decision = "reject";
+            }
+        }
+
+        // Dry run: Seconds;PeakBytes;PathSteps;N;Admission
+        if (args_.dryRun) {
+            out_ << cost.seconds << ";"
+                << static_cast<long long>(cost.peak_bytes) << ";"
+                << static_cast<long long>(cost.path_steps) << ";"
+                << w.N << ";"
+                << decision << "\n" << std::flush;
+            return false;
+        }
+
+        if (decision == "reject") {
+            std::ostringstream message;
+            message << "Request exceeds the limits: estimated " << cost.seconds << " s and "
+                << cost.peak_bytes / (1024.0 * 1024.0) << " MB.";
+            throw std::invalid_argument(message.str());
+        }
+
+        if (decision == "downscale") {
+            std::cerr << "Admission: N downscaled from " << args_.N << " to " << w.N << "\n";
+            args_.N = w.N;
+        }
+        return true;
+    }
+
+    void Interface::set_cancellation(std::shared_ptr<CancellationToken> token)
+    {
+        cancellation_ = std::move(token);
+    }
+
+    bool Interface::is_partial() const
+    {
+        return completion_.partial;
+    }
 
-        // Execute both modes in a single sequential stream
-        run_pricing_mode();
-        run_graph_mode();
+    std::string Interface::partial_status() const
+    {
+        std::ostringstream status;
+        status << completion_.paths << ";" << completion_.price_stderr << ";" << completion_.rows;
+        return status.str();
     }
 
-    // Calculate and print Price and Greeks 
-    void Interface::run_pricing_mode()
+    void Interface::run_excel_mode()
     {
-        std::unique_ptr<Pricing> option;
+        // Pricing, each Greek and every graph row are independent tasks on a shared pool,
+        // at most path_set_slots() of them holding a path set of their own at once
+        pathSets_ = std::make_unique<Semaphore>(path_set_slots(workload()));
+        TaskGraph graph;
+        if (args_.deadline <= 0.0)
+            run_pricing_mode(graph);
+        run_graph_mode(graph);
+
+        ThreadPool pool(worker_count());
+        graph.run(pool);
 
+        // Output keeps the sequential order, each line printed as soon as it is ready
+        try {
+            // With a deadline, the pricing line grows batch by batch so that a partial estimate exists
+            if (args_.deadline > 0.0)
+                run_deadline_pricing_mode();
+
+            if (args_.binaryFile.empty()) {
+                print_pricing_mode(graph);
+                print_graph_mode(graph);
+            }
+            else {
+                write_binary_output(graph);
+            }
+        }
+        catch (...) {
+            graph.wait_all();
+            throw;
+        }
+
+        // Rows stopped by the deadline may still be unwinding
+        graph.wait_all();
+
+        // End of the request: the option and all its buffers go at once
+        base_.reset();
+        requestArena_.reset();
+    }
+
+    ArenaPtr<Pricing> Interface::make_option(double S0, unsigned long seed,
+        const SimulationSettings& settings) const
+    {
         std::string type = args_.type;
         std::transform(type.begin(), type.end(), type.begin(),
             [](unsigned char c) { return std::tolower(c); });
 
         if (type == "call") {
-            option = std::make_unique<Call>(args_.t, args_.T, args_.S0, args_.r, args_.sigma,
-                args_.N, args_.dS, args_.M, args_.seed);
+            return make_arena<Call>(args_.t, args_.T, S0, args_.r, args_.sigma,
+                args_.N, args_.dS, args_.M, seed, settings);
         }
-        else if (type == "put") {
-            option = std::make_unique<Put>(args_.t, args_.T, args_.S0, args_.r, args_.sigma,
-                args_.N, args_.dS, args_.M, args_.seed);
+        if (type == "put") {
+            return make_arena<Put>(args_.t, args_.T, S0, args_.r, args_.sigma,
+                args_.N, args_.dS, args_.M, seed, settings);
         }
-        else {
-            throw std::runtime_error("Invalid option type. Use 'call' or 'put'.");
+
+        throw std::runtime_error("Invalid option type. Use 'call' or 'put'.");
+    }
+
+    // Schedule Price and Greeks
+    void Interface::run_pricing_mode(TaskGraph& graph)
+    {
+        // The shared option lives in the request arena, read concurrently by the estimators
+        const TaskGraph::TaskId build = graph.add([this]() {
+            ArenaScope scope(requestArena_);
+            base_ = make_option(args_.S0, args_.seed, args_.settings);
+        });
+
+        // Order of the Excel line: Price;Delta;Gamma;Theta;Rho;Vega
+        static const std::array<double (Pricing::*)() const, 6> estimators = {
+            &Pricing::price, &Pricing::delta, &Pricing::gamma,
+            &Pricing::theta, &Pricing::rho, &Pricing::vega
+        };
+
+        // Theta and Rho simulate a bumped run; the others only read the paths of base_
+        static const std::array<bool, 6> bumped = { false, false, false, true, true, false };
+
+        for (size_t j = 0; j < estimators.size(); ++j) {
+            pricingTasks_.push_back(graph.add([this, j]() {
+                SemaphoreGuard slot(bumped[j] ? pathSets_.get() : nullptr);
+
+                // Temporaries (estimator buffers, bumped runs) in the worker's arena
+                pricing_[j] = in_thread_arena([&]() { return ((*base_).*estimators[j])(); });
+            }, { build }));
         }
+    }
+
+    // Print Price and Greeks
+    void Interface::print_pricing_mode(TaskGraph& graph)
+    {
+        for (TaskGraph::TaskId id : pricingTasks_)
+            graph.wait(id);
 
         // Print results formatted for Excel: Price;Delta;Gamma;Theta;Rho;Vega
-        std::cout << option->price() << ";"
-            << option->delta() << ";"
-            << option->gamma() << ";"
-            << option->theta() << ";"
-            << option->rho() << ";"
-            << option->vega() << "\n";
+        out_ << pricing_[0] << ";"
+            << pricing_[1] << ";"
+            << pricing_[2] << ";"
+            << pricing_[3] << ";"
+            << pricing_[4] << ";"
+            << pricing_[5] << "\n" << std::flush;
     }
 
-    // Loop through spot prices to generate graph data points
-    void Interface::run_graph_mode()
+    // Schedule one task per spot price of the graph
+    void Interface::run_graph_mode(TaskGraph& graph)
     {
         // Centering the price range around S0
         double S_min = std::max(0.0, args_.S0 - (args_.M * args_.dS / 2.0));
@@ -95,30 +563,236 @@ namespace ensiie
         if (type != "call" && type != "put")
             throw std::runtime_error("Invalid option type. Use 'call' or 'put'.");
 
+        rows_.resize(args_.M + 1);
 
         for (int i = 0; i <= args_.M; ++i)
         {
             double current_S = S_min + i * args_.dS;
             unsigned long current_seed = args_.seed ; //understand   unsigned long current_seed = args_.seed + i;
 
-            std::unique_ptr<Pricing> option;
+            // Seasoned trade: a spot past the carried-in extreme is the new extreme
+            SimulationSettings settings = args_.settings;
+            if (!std::isnan(settings.running_extreme))
+                settings.running_extreme = (type == "call")
+                    ? std::min(settings.running_extreme, current_S)
+                    : std::max(settings.running_extreme, current_S);
 
-            if (type == "call") {
-                option = std::make_unique<Call>(args_.t, args_.T, current_S, args_.r, args_.sigma,
-                    args_.N, args_.dS, args_.M, current_seed);
-            }
-            else {
-                option = std::make_unique<Put>(args_.t, args_.T, current_S, args_.r, args_.sigma,
-                    args_.N, args_.dS, args_.M, current_seed);
-            }
+            rowTasks_.push_back(graph.add([this, i, current_S, current_seed, settings]() {
+                SemaphoreGuard slot(pathSets_.get());
+                rows_[i] = in_thread_arena([&]() {
+                    ArenaPtr<Pricing> option = make_option(current_S, current_seed, settings);
+                    return std::array<double, 3>{ current_S, option->price(), option->delta() };
+                });
+            }));
+        }
+
+        // Lowered by wait_row() if the deadline stops a row
+        completion_.rows = rowTasks_.size();
+    }
+
+    // Print the graph rows in order
+    void Interface::print_graph_mode(TaskGraph& graph)
+    {
+        for (size_t i = 0; i < rowTasks_.size(); ++i)
+        {
+            if (!wait_row(graph, i))
+                break;
 
             // Print graph row: Spot;Price;Delta
-            std::cout << current_S << ";"
-                << option->price() << ";"
-                << option->delta() << "\n";
+            out_ << rows_[i][0] << ";"
+                << rows_[i][1] << ";"
+                << rows_[i][2] << "\n";
         }
 
         // Ensure all data is sent through the pipe
-        std::cout << std::flush;
+        out_ << std::flush;
+    }
+
+    // Write the pricing line and the graph rows as binary columns
+    void Interface::write_binary_output(TaskGraph& graph)
+    {
+        for (TaskGraph::TaskId id : pricingTasks_)
+            graph.wait(id);
+
+        // Rows stopped by the deadline are left out
+        size_t rowCount = 0;
+        while (rowCount < rowTasks_.size() && wait_row(graph, rowCount))
+            ++rowCount;
+        graph.wait_all();
+        rows_.resize(rowCount);
+
+        std::vector<std::vector<double>> pricing(pricing_.size());
+        for (size_t j = 0; j < pricing_.size(); ++j)
+            pricing[j] = { pricing_[j] };
+
+        std::vector<std::vector<double>> graphColumns(3, std::vector<double>(rows_.size()));
+        for (size_t i = 0; i < rows_.size(); ++i)
+            for (size_t j = 0; j < 3; ++j)
+                graphColumns[j][i] = rows_[i][j];
+
+        ColumnarWriter writer;
+        writer.add_table("pricing", { "Price", "Delta", "Gamma", "Theta", "Rho", "Vega" }, pricing);
+        writer.add_table("graph", { "Spot", "Price", "Delta" }, graphColumns);
+        writer.save(args_.binaryFile);
+    }
+
+    // Simulate one shard and save its mergeable estimator state
+    void Interface::run_shard_mode()
+    {
+        in_thread_arena([&]() {
+            ArenaPtr<Pricing> option = make_option(args_.S0, args_.seed, args_.settings);
+            option->estimator_state().save(args_.stateFile);
+        });
+    }
+
+    // Merge shard states into the result of the full run
+    void Interface::run_merge_mode()
+    {
+        EstimatorState state = EstimatorState::load(args_.mergeFiles.front());
+        for (size_t i = 1; i < args_.mergeFiles.size(); ++i)
+            state.merge(EstimatorState::load(args_.mergeFiles[i]));
+
+        const EstimatorResult res = state.finalize();
+
+        // Same line as the pricing mode: Price;Delta;Gamma;Theta;Rho;Vega
+        out_ << res.price << ";"
+            << res.delta << ";"
+            << res.gamma << ";"
+            << res.theta << ";"
+            << res.rho << ";"
+            << res.vega << "\n" << std::flush;
+    }
+
+    // Accumulate the run over growing batches of blocks
+    std::unique_ptr<EstimatorState> Interface::accumulate_batches(
+        const std::function<void(const EstimatorState&)>& onBatch)
+    {
+        SimulationSettings settings = args_.settings;
+        const int nBlocks = MonteCarlo::block_count(args_.N);
+
+        std::unique_ptr<EstimatorState> state;
+
+        // Batches of 1, 2, 4, ... blocks: the first estimate comes after block_size paths
+        int batch = 1;
+        for (int first = 0; first < nBlocks; first += batch, batch *= 2)
+        {
+            batch = std::min(batch, nBlocks - first);
+            settings.block_begin = first;
+            settings.block_end = first + batch;
+
+            // Each batch reuses the arena of the previous one
+            try {
+                in_thread_arena([&]() {
+                    ArenaPtr<Pricing> option = make_option(args_.S0, args_.seed, settings);
+                    if (!state)
+                        state = std::make_unique<EstimatorState>(option->estimator_state());
+                    else
+                        option->accumulate(*state);
+                });
+            }
+            catch (const Cancelled& e) {
+                // Deadline: the blocks of the completed batches still give an estimate
+                if (!e.deadline_exceeded() || !state)
+                    throw;
+                return state;
+            }
+
+            onBatch(*state);
+        }
+
+        return state;
+    }
+
+    // Stream running estimates over growing batches of blocks
+    void Interface::run_progressive_mode()
+    {
+        const std::unique_ptr<EstimatorState> state = accumulate_batches([&](const EstimatorState& current) {
+            const EstimatorResult res = current.estimate();
+
+            // Price;Delta;Gamma;Theta;Rho;Vega;StdErr;Paths
+            out_ << res.price << ";"
+                << res.delta << ";"
+                << res.gamma << ";"
+                << res.theta << ";"
+                << res.rho << ";"
+                << res.vega << ";"
+                << res.price_stderr << ";"
+                << static_cast<long long>(res.paths) << "\n" << std::flush;
+        });
+
+        // The last line printed is the best estimate reached before the deadline
+        const EstimatorResult res = state->estimate();
+        completion_.partial = !state->complete();
+        completion_.paths = static_cast<long long>(res.paths);
+        completion_.price_stderr = res.price_stderr;
+    }
+
+    // Pricing line from the blocks simulated before the deadline
+    void Interface::run_deadline_pricing_mode()
+    {
+        const std::unique_ptr<EstimatorState> state = accumulate_batches([](const EstimatorState&) {});
+        const EstimatorResult res = state->estimate();
+
+        pricing_ = { res.price, res.delta, res.gamma, res.theta, res.rho, res.vega };
+
+        // Partial estimate: the line stays in the Excel format, its accuracy goes to partial_status()
+        completion_.partial = !state->complete();
+        completion_.paths = static_cast<long long>(res.paths);
+        completion_.price_stderr = res.price_stderr;
+    }
+
+    bool Interface::wait_row(TaskGraph& graph, size_t i)
+    {
+        try {
+            graph.wait(rowTasks_[i]);
+            return true;
+        }
+        catch (const Cancelled& e) {
+            if (!e.deadline_exceeded())
+                throw;
+            completion_.partial = true;
+            completion_.rows = i;
+            return false;
+        }
+    }
+
+    // Second-order Greeks from the paths of the base run
+    void Interface::run_second_order_mode()
+    {
+        std::array<double, 6> line{};
+        in_thread_arena([&]() {
+            ArenaPtr<Pricing> option = make_option(args_.S0, args_.seed, args_.settings);
+            const Pricing::SecondOrderGreeks second = option->second_order_greeks();
+            line = { option->price(), option->delta(), second.gamma, second.vanna, option->vega(), second.volga };
+        });
+
+        // Price;Delta;Gamma;Vanna;Vega;Volga
+        out_ << line[0] << ";"
+            << line[1] << ";"
+            << line[2] << ";"
+            << line[3] << ";"
+            << line[4] << ";"
+            << line[5] << "\n" << std::flush;
+    }
+
+    // Richardson extrapolation of the discrete-monitoring bias
+    void Interface::run_richardson_mode()
+    {
+        const int coarseSteps = std::max(1, static_cast<int>(std::lround((args_.T - args_.t) * args_.richardsonPerYear)));
+
+        const RichardsonResult res = in_thread_arena([&]() {
+            const RichardsonEstimator estimator(args_.t, args_.T, args_.S0, args_.r, args_.sigma, args_.N,
+                args_.type, args_.seed, coarseSteps, args_.refinement, args_.settings);
+            return estimator.run();
+        });
+
+        // Price;Delta;Vega;Bias;StdErr;CoarsePrice;FinePrice
+        out_ << res.price << ";"
+            << res.delta << ";"
+            << res.vega << ";"
+            << res.bias << ";"
+            << res.std_error << ";"
+            << res.price_coarse << ";"
+            << res.price_fine << "\n" << std::flush;
     }
-}
\ No newline at end of file
+}
@@ -1,8 +1,17 @@
 #pragma once
 
+#include <set>
 #include <string>
 #include <vector>
-#include "data.h"
+#include <array>
+#include <memory>
+#include <functional>
+#include <iostream>
+#include "pricing.h"
+#include "Arena.h"
+#include "TaskGraph.h"
+#include "ThreadPool.h"
+#include "CostModel.h"
 
 
 namespace ensiie {
@@ -10,6 +19,47 @@ namespace ensiie {
     /**
      * @brief Interface to comunicate with Excel
      * * This class handles the parsing of command-line arguments.
+     *
+     * Besides the Excel call (10 positional arguments), it supports sharded runs:
+     *   - pricer type t T S0 r sigma N dS M seed --shard=i/n --state=file
+     *     simulates shard i of n and writes its estimator state to file;
+     *   - pricer merge file1 file2 ...
+     *     merges the shard states and prints Price;Delta;Gamma;Theta;Rho;Vega,
+     *     exactly as the unsharded run would.
+     *
+     * With --richardson=F, the run prints the Richardson extrapolation (dt -> 0) of
+     * the prices on grids of F and F x refinement steps a year.
+     *
+     * Engine buffers come from arenas (see Arena.h): the request arena holds the
+     * option shared by the pricing tasks, and each task's temporaries go to the
+     * arena of its worker thread, released when the task ends. --alloc-stats prints
+     * the heap allocations of the run to stderr (builds with -DLOOKBACK_ALLOC_STATS only).
+     *
+     * Pool workers are pinned to the NUMA nodes (see Numa.h); --numa-stats prints the
+     * simulated path steps, time and throughput of each node to stderr.
+     *
+     * With --binary=file, the Excel run writes its pricing line and graph rows to file
+     * in the binary columnar format of ColumnarWriter instead of printing them.
+     *
+     * With --second-order, the run prints Price;Delta;Gamma;Vanna;Vega;Volga.
+     *
+     * With --normal-store=dir, antithetic runs read their Gaussians from memory-mapped
+     * files of dir (see NormalStore), written by the first run of each stream.
+     *
+     * With --deadline=S, the run stops S seconds after it started: the Excel run prints
+     * the pricing line estimated from the blocks of paths simulated so far and the
+     * graph rows finished in time; the progressive run ends on its last complete batch.
+     * Nothing marks the output itself: is_partial() and partial_status() tell the
+     * caller (stderr for the command line, a PARTIAL line for PricingServer). Other
+     * modes fail with Cancelled. A server may also cancel the run through
+     * set_cancellation().
+     *
+     * Before simulating, the cost of the request can be predicted (--dry-run) and
+     * checked against limits (--max-seconds, --max-memory); see admit().
+     *
+     * With --progressive, the run streams one Price;Delta;Gamma;Theta;Rho;Vega;StdErr;Paths
+     * line per batch of paths (batches double in size), the last line being the
+     * estimate over all N paths.
      */
 
     class Interface {
@@ -18,14 +68,37 @@ namespace ensiie {
          * @brief Constructor that initializes the interface with command-line arguments.
          * @param argc Number of command-line arguments.
          * @param argv Array of command-line argument strings.
+         * @param out Stream receiving the results (std::cout for Excel).
          */
-        Interface(int argc, char* argv[]);
+        Interface(int argc, char* argv[], std::ostream& out = std::cout);
 
         /**
          * @brief Main execution entry point.
+         *
+         * Throws Cancelled if the run was cancelled, or if its deadline passed
+         * before any estimate was available.
          */
         void run();
 
+        /**
+         * @brief Shares a cancellation token with the caller, which may cancel the run
+         * from another thread. --deadline sets the deadline of this token.
+         */
+        void set_cancellation(std::shared_ptr<CancellationToken> token);
+
+        /**
+         * @brief Returns true if the deadline stopped the run before all its paths
+         * or graph rows were done (the output is then a partial answer).
+         */
+        bool is_partial() const;
+
+        /**
+         * @brief Completion of a run stopped by its deadline, as "Paths;StdErr;Rows": the
+         * paths behind the last estimate, the standard error of its price and the
+         * number of graph rows written.
+         */
+        std::string partial_status() const;
+
     private:
         /**
          * @struct InputArgs
@@ -42,22 +115,211 @@ namespace ensiie {
             int N;             
             int M;             
             unsigned long seed;
+            SimulationSettings settings;   ///< Optional "--key=value" arguments after the seed
+            std::string stateFile;         ///< Estimator state output of a shard run
+            std::vector<std::string> mergeFiles; ///< Estimator states to merge
+            double richardsonPerYear = 0.0;      ///< Coarse steps a year of the Richardson mode
+            int refinement = 2;                  ///< Fine steps per coarse step of the Richardson mode
+            std::string binaryFile;              ///< Binary columnar output of the Excel mode (empty: text)
+            double deadline = 0.0;               ///< Seconds the run may take (0: no deadline)
+            bool dryRun = false;                 ///< Print the cost estimate instead of running
+            double maxSeconds = 0.0;             ///< Predicted wall time limit (0: none)
+            double maxMemoryMB = 0.0;            ///< Predicted peak memory limit in MB (0: none)
+            bool downscale = false;              ///< Downscale N to the limits instead of rejecting
         } args_;
 
+        /** @brief Stream receiving the results. */
+        std::ostream& out_;
+
+        /** @brief Cancellation token of the run (null: no deadline and not cancellable). */
+        std::shared_ptr<CancellationToken> cancellation_;
+
+        /** @brief Print the heap allocation counts of the run to stderr (--alloc-stats). */
+        bool allocStats_ = false;
+
+        /** @brief Print the per-node simulation throughput to stderr (--numa-stats). */
+        bool numaStats_ = false;
+
+        /** @brief Execution mode selected by the command line. */
+        enum class Mode { Excel, Shard, Merge, Progressive, Richardson, SecondOrder } mode_ = Mode::Excel;
+
+        /** @brief Option that selected mode_ (e.g. "--richardson"), for error messages. */
+        std::string modeOption_;
+
+        /** @brief Keys of the optional arguments given (e.g. "refinement"). */
+        std::set<std::string> options_;
+
+        /**
+         * @brief Selects the mode of a mode option.
+         *
+         * Throws std::invalid_argument if another option already selected a different mode.
+         */
+        void select_mode(Mode mode, const std::string& option);
+
+        /**
+         * @brief Rejects options the selected mode would silently ignore (std::invalid_argument):
+         * --refinement without --richardson, --strata without stratified sampling,
+         * --admission without a limit, --binary outside the Excel mode, and with --dry-run
+         * (nothing simulated) --deadline, --binary, --normal-store, --alloc-stats and --numa-stats.
+         */
+        void check_options() const;
+
         /**
          * @brief Converts raw command-line strings into numeric data.
+         *
+         * Throws std::invalid_argument for an argument after the seed that is not a
+         * "--key=value" option.
          * @param argc Number of arguments.
          * @param argv Array of strings.
          */
         void parse_arguments(int argc, char* argv[]);
 
         /**
-         * @brief Calculates Price and all Greeks (Delta, Gamma, Theta, Rho, Vega) 
+         * @brief Parses one optional "--key=value" argument.
+         *
+         * Supported: --precision=double|single, --shard=i/n, --state=file, --progressive,
+         * --sampling=antithetic|stratified, --strata=K, --drift-shift=theta,
+         * --rate-curve=T1:r1,T2:r2,..., --vol-curve=T1:s1,T2:s2,...,
+         * --fixings=d1,d2,..., --fixings-per-year=F, --running-extreme=X,
+         * --richardson=F, --refinement=2|4, --second-order, --binary=file, --normal-store=dir,
+         * --deadline=seconds, --dry-run, --max-seconds=S, --max-memory=MB,
+         * --admission=reject|downscale, --alloc-stats and --numa-stats.
+         * The mode options (--progressive, --richardson, --second-order, --shard) are
+         * exclusive; see also check_options().
+         * @param option Raw argument string.
+         */
+        void parse_option(const std::string& option);
+
+        /** @brief Work of the parsed request in the selected mode, for the cost model. */
+        Workload workload() const;
+
+        /**
+         * @brief Number of Excel-run tasks (Theta and Rho bumps, graph rows) that may hold
+         * a path set of w at once besides the base run: the memory budget (--max-memory,
+         * or 2 GB) over the bytes of one path set, minus the base run, at least 1.
+         */
+        int path_set_slots(const Workload& w) const;
+
+        /**
+         * @brief Admission control: predicts the cost of the request (CostModel) and
+         * checks it against --max-seconds and --max-memory.
+         *
+         * An oversized request is rejected (std::invalid_argument), or with
+         * --admission=downscale run with N reduced to the limits. With --dry-run,
+         * prints Seconds;PeakBytes;PathSteps;N;Admission and returns false.
+         * @return true if the request should run.
+         */
+        bool admit();
+
+        /**
+         * @brief Builds the option of the parsed type for a given spot, in the current arena.
+         * @param S0 Spot price.
+         * @param seed Random number generator seed.
+         * @param settings Simulation settings.
+         */
+        ArenaPtr<Pricing> make_option(double S0, unsigned long seed,
+            const SimulationSettings& settings) const;
+
+        /** @brief Arena of the request: holds base_ and its buffers, released at the end of run(). */
+        Arena requestArena_;
+
+        /** @brief Option at the input spot, shared by the pricing tasks. */
+        ArenaPtr<Pricing> base_;
+
+        /** @brief Price;Delta;Gamma;Theta;Rho;Vega, filled by the pricing tasks. */
+        std::array<double, 6> pricing_{};
+
+        /** @brief Spot;Price;Delta of each graph row, filled by the graph tasks. */
+        std::vector<std::array<double, 3>> rows_;
+
+        /** @brief Tasks producing pricing_ and rows_, in output order. */
+        std::vector<TaskGraph::TaskId> pricingTasks_, rowTasks_;
+
+        /** @brief Bounds the tasks simulating a path set of their own (see path_set_slots()). */
+        std::unique_ptr<Semaphore> pathSets_;
+
+        /** @brief What a run with a deadline completed (see partial_status()). */
+        struct Completion {
+            bool partial = false;      ///< The deadline stopped some paths or graph rows
+            long long paths = 0;       ///< Paths behind the last estimate
+            double price_stderr = 0.0; ///< Standard error of its price
+            size_t rows = 0;           ///< Graph rows written
+        } completion_;
+
+        /** @brief Runs the pricing line and the graph rows on the task graph (Excel call). */
+        void run_excel_mode();
+
+        /**
+         * @brief Schedules Price and all Greeks (Delta, Gamma, Theta, Rho, Vega) as tasks.
+         *
+         * One task builds the option; price and each Greek then run concurrently.
+         */
+        void run_pricing_mode(TaskGraph& graph);
+
+        /** @brief Waits for the pricing tasks and prints Price;Delta;Gamma;Theta;Rho;Vega. */
+        void print_pricing_mode(TaskGraph& graph);
+
+        /**
+         * @brief Simulates one shard and writes its estimator state to the state file.
+         */
+        void run_shard_mode();
+
+        /**
+         * @brief Merges shard estimator states and prints Price;Delta;Gamma;Theta;Rho;Vega.
+         */
+        void run_merge_mode();
+
+        /**
+         * @brief Simulates in geometrically growing batches of blocks and prints the
+         * running estimates after each batch.
+         */
+        void run_progressive_mode();
+
+        /**
+         * @brief Accumulates the estimator state of the run over batches of 1, 2, 4, ...
+         * blocks, calling onBatch after each batch.
+         *
+         * If the deadline passes, returns the state of the completed batches; rethrows
+         * Cancelled if the run was cancelled or no batch was completed.
+         */
+        std::unique_ptr<EstimatorState> accumulate_batches(
+            const std::function<void(const EstimatorState&)>& onBatch);
+
+        /**
+         * @brief Fills pricing_ from the blocks simulated before the deadline (Excel run
+         * with --deadline) and records its paths and standard error in completion_.
+         */
+        void run_deadline_pricing_mode();
+
+        /**
+         * @brief Waits for graph row i. Returns false, recording the rows written in
+         * completion_, if the deadline stopped it.
+         */
+        bool wait_row(TaskGraph& graph, size_t i);
+
+        /**
+         * @brief Prices on a coarse grid of F steps a year and its refinement, and prints
+         * Price;Delta;Vega;Bias;StdErr;CoarsePrice;FinePrice of the Richardson extrapolation.
+         */
+        void run_richardson_mode();
+
+        /**
+         * @brief Prints Price;Delta;Gamma;Vanna;Vega;Volga, the second-order Greeks
+         * coming from the paths of the base run (no bumped simulation).
          */
-        void run_pricing_mode();
+        void run_second_order_mode();
         /**
-        * @brief Calculates and prints M rows of: Spot;Price;Delta.         */
-        void run_graph_mode();
+        * @brief Schedules one independent task per graph row (Spot;Price;Delta).         */
+        void run_graph_mode(TaskGraph& graph);
+
+        /** @brief Prints the M + 1 graph rows in order, each as soon as it is ready. */
+        void print_graph_mode(TaskGraph& graph);
+
+        /**
+         * @brief Writes the pricing line and the graph rows to the --binary file, as the
+         * "pricing" and "graph" tables of a ColumnarWriter file (full double precision).
+         */
+        void write_binary_output(TaskGraph& graph);
     };
 }
  
\ No newline at end of file
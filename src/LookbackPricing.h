@@ -0,0 +1,498 @@
+#pragma once
+#include "pricing.h"
+#include "Payoff.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace ensiie
+{
+    /**
+     * @brief Lookback pricer instantiated at compile time for a payoff policy.
+     *
+     * Implements the Pricing virtual interface on top of the kernels of Payoff.h:
+     * the virtual call happens once per estimator, while the per-path loops are
+     * instantiated for the policy and fully inlined.
+     *
+     * @tparam Payoff LookbackCallPayoff or LookbackPutPayoff.
+     */
+    template <class Payoff>
+    class LookbackPricing : public Pricing
+    {
+    public:
+        /**
+         * @brief Constructor.
+         *
+         * @param t Initial time.
+         * @param T Maturity time.
+         * @param S0 Spot price.
+         * @param r Risk-free interest rate.
+         * @param sigma Underlying asset's volatility.
+         * @param N Number of Monte Carlo Simulations.
+         * @param dS Price grid step (inherited parameter).
+         * @param M Number of discrete price nodes (inherited parameter).
+         * @param seed Random number generator seed.
+         * @param settings Optional simulation settings (e.g. path precision).
+         */
+        LookbackPricing(double t, double T, double S0, double r, double sigma,
+            int N, double dS, int M, unsigned long seed,
+            const SimulationSettings& settings = SimulationSettings())
+            : Pricing(t, T, S0, r, sigma, N, dS, M, Payoff::name, seed, settings)
+        {
+        }
+
+        /**
+         * @brief Computes the payoff for a specific simulated path.
+         *
+         * @param path Vector containing the simulated price trajectory.
+         * @return The calculated payoff value.
+         */
+        double payoff(const std::vector<double>& path) const override;
+
+        // GREEKS
+
+        /**
+         * @brief Computes Delta using pathwise approach.
+         *
+         * The payoff is homogeneous of degree one in S0, so the pathwise
+         * derivative of each path is payoff / S0 (for a seasoned trade, the
+         * carried-in extreme does not scale: see evaluate_delta_payoffs()).
+         * @return The sensitivity of the price to the underlying asset price.
+         */
+        double delta() const override;
+
+        /**
+         * @brief Gamma: zero for a fresh trade, whose price is linear in S0.
+         *
+         * For a seasoned trade the carried-in extreme breaks the homogeneity:
+         * see evaluate_gammas().
+         * @return The sensitivity of Delta to the underlying asset price.
+         */
+        double gamma() const override;
+
+        /**
+         * @brief Computes Vega using pathwise approach.
+         * @return The sensitivity of the price to volatility.
+         */
+        double vega() const override;
+
+        /**
+         * @brief Computes Theta using Forward Finite Differences.
+         * @return The sensitivity of the price to time passage.
+         */
+        double theta() const override;
+
+        /**
+         * @brief Computes Rho using Forward Finite Differences.
+         * @return The sensitivity of the price to the risk-free rate.
+         */
+        double rho() const override;
+
+        /**
+         * @brief Gamma, Vanna and Volga in one sweep over the stored paths.
+         *
+         * Throws std::invalid_argument with a rate or volatility term structure, or a
+         * zero volatility: Volga rests on the scaling of the paths in a flat sigma.
+         */
+        SecondOrderGreeks second_order_greeks() const override;
+
+        /** @brief Adds the block sums of payoff (with its centered sum of squares), delta, gamma, vega and the Theta/Rho bumped payoffs. */
+        void accumulate(EstimatorState& state) const override;
+
+    protected:
+        void evaluate_payoffs(double* out) const override;
+
+        /** @brief Writes the (likelihood-ratio weighted) pathwise vega of each stored path into out. */
+        void evaluate_vegas(double* out) const;
+
+        /**
+         * @brief Writes S0 times the pathwise delta of each stored path into out.
+         *
+         * Equal to the payoffs for a fresh trade (homogeneous in S0); for a seasoned
+         * one the carried-in extreme does not scale with S0.
+         */
+        void evaluate_delta_payoffs(double* out) const;
+
+        /**
+         * @brief Writes the (likelihood-ratio weighted) gamma of each stored path into out.
+         *
+         * Zero for a fresh trade. For a seasoned one, the pathwise delta jumps when the
+         * path extreme crosses the carried-in one, so its derivative in log S0 is taken
+         * by the likelihood ratio of the first step, Z_1 / sqrt(V_1).
+         */
+        void evaluate_gammas(double* out) const;
+
+        /**
+         * @brief Writes the per-path gamma, vanna and volga of each stored path.
+         *
+         * Vanna is vega / S0 for a fresh trade and the first-step likelihood ratio of
+         * the pathwise vega for a seasoned one. Volga uses log(S_k / S0) = sigma B_k,
+         * B a Brownian motion with drift nu = r / sigma - sigma / 2: for fixed B the
+         * payoff is smooth in sigma (the extreme time does not move), and sigma only
+         * enters the law of B through nu, whose likelihood ratio is nu' W_T. The kink
+         * of a seasoned payoff at the carried-in extreme adds a density term, also
+         * estimated from the first-step likelihood ratio.
+         */
+        void evaluate_second_order(double* gamma, double* vanna, double* volga) const;
+
+        /** @brief Settings of the Rho bumped run (rate curve shifted by rho_step). */
+        SimulationSettings rho_settings() const;
+    };
+
+    // PAYOFF
+    template <class Payoff>
+    double LookbackPricing<Payoff>::payoff(const std::vector<double>& path) const
+    {
+        const int n = static_cast<int>(path.size());
+
+        if (!is_seasoned())
+            return kernels::payoff<Payoff>(path.data(), n);
+
+        // Extreme over the carried-in value and the path
+        double ext = kernels::extreme_value<Payoff>(path.data(), n);
+        if (!Payoff::beats(ext, settings_.running_extreme))
+            ext = settings_.running_extreme;
+        return Payoff::sign * (path[n - 1] - ext);
+    }
+
+    template <class Payoff>
+    void LookbackPricing<Payoff>::evaluate_payoffs(double* out) const
+    {
+        const int N = get_path_count();
+        const int n = get_Nt() + 1;
+
+        if (is_seasoned())
+        {
+            const PathSummary& s = get_path_summary();
+            for (int i = 0; i < N; ++i)
+                out[i] = Payoff::sign * (s.terminal[i] - s.extreme[i]);
+
+            apply_weights(out);
+            return;
+        }
+
+        visit_paths([&](const auto& paths)
+            {
+                for (int i = 0; i < N; ++i)
+                {
+                    out[i] = kernels::payoff<Payoff>(paths[i], n);
+                }
+            });
+
+        apply_weights(out);
+    }
+
+    // DELTA
+    template <class Payoff>
+    void LookbackPricing<Payoff>::evaluate_delta_payoffs(double* out) const
+    {
+        if (!is_seasoned())
+        {
+            evaluate_payoffs(out);
+            return;
+        }
+
+        // The carried-in extreme does not move with S0: only S_T, and the
+        // path extreme if it beat the carried one, scale with the spot
+        const PathSummary& s = get_path_summary();
+        for (int i = 0; i < get_path_count(); ++i)
+            out[i] = Payoff::sign * (s.terminal[i] - (s.beaten[i] ? s.extreme[i] : 0.0));
+
+        apply_weights(out);
+    }
+
+    template <class Payoff>
+    double LookbackPricing<Payoff>::delta() const
+    {
+        // Pathwise derivative: payoff / S0, averaged and discounted
+        if (!is_seasoned())
+            return price() / S0_;
+
+        ArenaVector<double> values(get_path_count());
+        evaluate_delta_payoffs(values.data());
+
+        return get_discount() * (sum_over_paths(values) / static_cast<double>(get_path_count())) / S0_;
+    }
+
+    // GAMMA
+    template <class Payoff>
+    void LookbackPricing<Payoff>::evaluate_gammas(double* out) const
+    {
+        const int N = get_path_count();
+
+        // Degenerate first step (no step, or zero volatility): the a.e. pathwise gamma is 0
+        if (!is_seasoned() || get_Nt() == 0 || !(get_diffusion_table()[0] > 0.0))
+        {
+            std::fill(out, out + N, 0.0);
+            return;
+        }
+
+        // d2V / dS0^2 = (d2V / du^2 - dV / du) / S0^2 with u = log S0, the derivative
+        // of the pathwise delta in u coming from the density of the first step
+        const PathSummary& s = get_path_summary();
+        const double d1 = get_diffusion_table()[0];
+        for (int i = 0; i < N; ++i)
+        {
+            const double moved = Payoff::sign * (s.terminal[i] - (s.beaten[i] ? s.extreme[i] : 0.0));
+            out[i] = moved * (s.first_increment[i] / d1 - 1.0) / (S0_ * S0_);
+        }
+
+        apply_weights(out);
+    }
+
+    template <class Payoff>
+    double LookbackPricing<Payoff>::gamma() const
+    {
+        // Fresh trade: the price is S0 times a function of (r, sigma, t, T)
+        if (!is_seasoned())
+            return 0.0;
+
+        ArenaVector<double> values(get_path_count());
+        evaluate_gammas(values.data());
+
+        return get_discount() * (sum_over_paths(values) / static_cast<double>(get_path_count()));
+    }
+
+    // SECOND ORDER
+    template <class Payoff>
+    void LookbackPricing<Payoff>::evaluate_second_order(double* gamma, double* vanna, double* volga) const
+    {
+        const int N = get_path_count();
+        const int n = get_Nt() + 1;
+        const double sigma = sigma_;
+
+        // Drift of B and its derivatives in sigma
+        const double dnu = -r_ / (sigma * sigma) - 0.5;
+        const double d2nu = 2.0 * r_ / (sigma * sigma * sigma);
+        const double tau = get_time_grid().back() - get_time_grid().front();
+
+        double logDrift = 0.0;
+        for (double m : get_drift_table())
+            logDrift += m;
+
+        // Volga of one path: d2g / dsigma2 + 2 dg / dsigma s + g (s^2 + ds / dsigma), with
+        // s = nu' W_T the score of sigma; moved is the extreme if it scales with the path, else 0
+        auto path_volga = [&](double ST, double extreme, double moved)
+        {
+            const double BT = std::log(ST / S0_) / sigma;
+            const double Bm = (moved != 0.0) ? std::log(moved / S0_) / sigma : 0.0;
+            const double W = (sigma * BT - logDrift) / sigma;
+            const double score = dnu * W;
+            const double dscore = d2nu * W - dnu * dnu * tau;
+
+            const double g = Payoff::sign * (ST - extreme);
+            const double gs = Payoff::sign * (ST * BT - moved * Bm);
+            const double gss = Payoff::sign * (ST * BT * BT - moved * Bm * Bm);
+            return gss + 2.0 * gs * score + g * (score * score + dscore);
+        };
+
+        if (is_seasoned())
+        {
+            const PathSummary& s = get_path_summary();
+            const double d1 = get_diffusion_table()[0];
+            const double a1 = get_vol_table()[0];
+            const double c = std::log(settings_.running_extreme / S0_) / sigma;
+
+            for (int i = 0; i < N; ++i)
+            {
+                const double moved = s.beaten[i] ? s.extreme[i] : 0.0;
+                const double movedDelta = Payoff::sign * (s.terminal[i] - moved);
+                const double pathVega = Payoff::sign * (s.terminal[i] * s.dlog_terminal[i]
+                    - (s.beaten[i] ? s.extreme[i] * s.dlog_extreme[i] : 0.0));
+                const double spotScore = s.first_increment[i] / d1;
+
+                gamma[i] = movedDelta * (spotScore - 1.0) / (S0_ * S0_);
+
+                // Z_1 depends on log S0 explicitly: d(d log S_k / dsigma) / du = -A_1 / V_1
+                vanna[i] = (pathVega * spotScore - movedDelta * a1 / (d1 * d1)) / S0_;
+
+                // Kink at B_m = c: c^2 times the density term e^c p(c), itself the gap
+                // between the pathwise and likelihood-ratio u-derivatives of the beaten extreme
+                volga[i] = path_volga(s.terminal[i], s.extreme[i], moved)
+                    + c * c * Payoff::sign * moved * (1.0 - spotScore);
+            }
+        }
+        else
+        {
+            const bool steps = has_fixing_schedule();
+            const double dt = get_dt();
+            const double* drift = get_drift_table().data();
+            const double* diffusion = get_diffusion_table().data();
+            const double* vol = get_vol_table().data();
+
+            visit_paths([&](const auto& paths)
+                {
+                    for (int i = 0; i < N; ++i)
+                    {
+                        const auto* path = paths[i];
+                        const double pathVega = steps
+                            ? kernels::pathwise_vega_steps<Payoff>(path, n, drift, diffusion, vol)
+                            : kernels::pathwise_vega<Payoff>(path, n, S0_, r_, sigma_, dt);
+                        const double extreme = kernels::extreme_value<Payoff>(path, n);
+
+                        // Price linear in S0: gamma is 0 and vanna is vega / S0, path by path
+                        gamma[i] = 0.0;
+                        vanna[i] = pathVega / S0_;
+                        volga[i] = path_volga(path[n - 1], extreme, extreme);
+                    }
+                });
+        }
+
+        apply_weights(gamma);
+        apply_weights(vanna);
+        apply_weights(volga);
+    }
+
+    template <class Payoff>
+    Pricing::SecondOrderGreeks LookbackPricing<Payoff>::second_order_greeks() const
+    {
+        if (has_term_structure())
+            throw std::invalid_argument("Second-order Greeks need a flat rate and volatility.");
+        if (!(sigma_ > 0.0) || get_Nt() == 0)
+            throw std::invalid_argument("Second-order Greeks need a positive volatility and at least one step.");
+
+        const int N = get_path_count();
+        ArenaVector<double> gammas(N), vannas(N), volgas(N);
+        evaluate_second_order(gammas.data(), vannas.data(), volgas.data());
+
+        const double scale = get_discount() / static_cast<double>(N);
+        return SecondOrderGreeks{ scale * sum_over_paths(gammas), scale * sum_over_paths(vannas),
+            scale * sum_over_paths(volgas) };
+    }
+
+    // VEGA
+    template <class Payoff>
+    void LookbackPricing<Payoff>::evaluate_vegas(double* out) const
+    {
+        const int N = get_path_count();
+        const int n = get_Nt() + 1;
+        const double dt = get_dt();
+
+        if (is_seasoned())
+        {
+            // dS/dsigma = S dlog S/dsigma at maturity and at a beating extreme
+            const PathSummary& s = get_path_summary();
+            for (int i = 0; i < N; ++i)
+            {
+                const double dExtreme = s.beaten[i] ? s.extreme[i] * s.dlog_extreme[i] : 0.0;
+                out[i] = Payoff::sign * (s.terminal[i] * s.dlog_terminal[i] - dExtreme);
+            }
+
+            apply_weights(out);
+            return;
+        }
+
+        // Term structures or fixing schedule: chain rule through the per-step coefficient tables
+        const bool steps = has_term_structure() || has_fixing_schedule();
+        const double* drift = get_drift_table().data();
+        const double* diffusion = get_diffusion_table().data();
+        const double* vol = get_vol_table().data();
+
+        visit_paths([&](const auto& paths)
+            {
+                for (int i = 0; i < N; ++i)
+                {
+                    out[i] = steps
+                        ? kernels::pathwise_vega_steps<Payoff>(paths[i], n, drift, diffusion, vol)
+                        : kernels::pathwise_vega<Payoff>(paths[i], n, S0_, r_, sigma_, dt);
+                }
+            });
+
+        apply_weights(out);
+    }
+
+    template <class Payoff>
+    double LookbackPricing<Payoff>::vega() const
+    {
+        const int N = get_path_count();
+
+        ArenaVector<double> values(N);
+        evaluate_vegas(values.data());
+
+        return get_discount() * (sum_over_paths(values) / static_cast<double>(N));
+    }
+
+    // THETA
+    template <class Payoff>
+    double LookbackPricing<Payoff>::theta() const
+    {
+        const double eps_theta = theta_step(t_, T_);
+
+        // Only the bumped run is simulated: the base price comes from this object
+        LookbackPricing forward(t_ + eps_theta, T_, S0_, r_, sigma_, N_, dS_, M_, seed_, settings_);
+
+        // Forward finite difference
+        return (forward.price() - price()) / eps_theta;
+    }
+
+    // RHO
+    template <class Payoff>
+    SimulationSettings LookbackPricing<Payoff>::rho_settings() const
+    {
+        // Parallel shift of the rate curve (no-op on a flat rate)
+        SimulationSettings bumped = settings_;
+        bumped.rate_curve = settings_.rate_curve.shifted(rho_step);
+        return bumped;
+    }
+
+    template <class Payoff>
+    double LookbackPricing<Payoff>::rho() const
+    {
+        LookbackPricing up(t_, T_, S0_, r_ + rho_step, sigma_, N_, dS_, M_, seed_, rho_settings());
+
+        // Forward finite difference
+        return (up.price() - price()) / rho_step;
+    }
+
+    // ESTIMATOR STATE
+    template <class Payoff>
+    void LookbackPricing<Payoff>::accumulate(EstimatorState& state) const
+    {
+        const int N = get_path_count();
+
+        // Same slice of blocks with the Theta and Rho bumps
+        LookbackPricing forward(t_ + theta_step(t_, T_), T_, S0_, r_, sigma_, N_, dS_, M_, seed_, settings_);
+        LookbackPricing up(t_, T_, S0_, r_ + rho_step, sigma_, N_, dS_, M_, seed_, rho_settings());
+
+        ArenaVector<double> values(N);
+        auto totals = [&](auto&& fill)
+        {
+            throw_if_stop_requested();
+            fill(values.data());
+            return block_totals(values.data(), N);
+        };
+
+        throw_if_stop_requested();
+        evaluate_payoffs(values.data());
+        const ArenaVector<Moments> payoff = block_moments(values.data(), N);
+
+        const ArenaVector<double> payoffDelta = totals([&](double* out) { evaluate_delta_payoffs(out); });
+        const ArenaVector<double> gamma = totals([&](double* out) { evaluate_gammas(out); });
+        const ArenaVector<double> vega = totals([&](double* out) { evaluate_vegas(out); });
+        const ArenaVector<double> payoffTheta = totals([&](double* out) { forward.evaluate_payoffs(out); });
+        const ArenaVector<double> payoffRho = totals([&](double* out) { up.evaluate_payoffs(out); });
+
+        // Merging a local state checks that both describe the same run
+        EstimatorState local(optionType_, t_, T_, S0_, r_, sigma_, N_, seed_, settings_);
+
+        for (int j = 0; j < get_local_block_count(); ++j)
+        {
+            BlockSums sums;
+            sums.count = static_cast<double>(std::min(block_size, N - j * block_size));
+            sums.payoff = payoff[j].sum;
+            sums.payoff_m2 = payoff[j].m2;
+            sums.payoff_delta = payoffDelta[j];
+            sums.gamma = gamma[j];
+            sums.vega = vega[j];
+            sums.payoff_theta = payoffTheta[j];
+            sums.payoff_rho = payoffRho[j];
+            local.set_block(get_first_block() + j, sums);
+        }
+
+        state.merge(local);
+    }
+
+    extern template class LookbackPricing<LookbackCallPayoff>;
+    extern template class LookbackPricing<LookbackPutPayoff>;
+}
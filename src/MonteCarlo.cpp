@@ -1,96 +1,721 @@
 #include "MonteCarlo.h"
+#include "Numa.h"
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
 #include <random>
 #include <cmath>
+#include <cstdint>
+#include <stdexcept>
 
 namespace ensiie
 {
-    MonteCarlo::MonteCarlo(double t, double T, double S0, double r, double sigma,
-        int N, double dS, int M, const std::string& optionStr, unsigned long seed)
-        : Data(t, T, S0, r, sigma, N, dS, M, optionStr, seed)
+    namespace
     {
-        // Time discretization: daily steps between t_ and T_.
-        dt_ = 1.0 / 252.0;
-        Nt_ = static_cast<int>((T_ - t_) * 252.0);
+        /**
+         * @brief Seed sequence of a block: the std::seed_seq algorithm on the three
+         * words (seed low, seed high, block), without std::seed_seq's heap copy of them.
+         *
+         * Generates exactly the std::seed_seq output, so the streams are unchanged
+         * while seeding a block stays allocation-free.
+         */
+        class BlockSeed
+        {
+        public:
+            using result_type = std::uint_least32_t;
 
-        if (Nt_ <= 0)
-            throw std::invalid_argument(
-                "Invalid time domain: T must be larger than t by at least 1 day.");
+            BlockSeed(unsigned long seed, int b)
+            {
+                const unsigned long long s = seed;
+                v_[0] = static_cast<std::uint32_t>(s);
+                v_[1] = static_cast<std::uint32_t>(s >> 32);
+                v_[2] = static_cast<std::uint32_t>(b);
+            }
+
+            template <class It>
+            void generate(It begin, It end) const
+            {
+                const std::size_t n = static_cast<std::size_t>(end - begin);
+                if (n == 0)
+                    return;
+
+                const std::size_t s = 3;
+                const std::size_t t = (n >= 623) ? 11 : (n >= 68) ? 7 : (n >= 39) ? 5 : (n >= 7) ? 3 : (n - 1) / 2;
+                const std::size_t p = (n - t) / 2;
+                const std::size_t q = p + t;
+                const std::size_t m = std::max(s + 1, n);
+
+                auto at = [&](std::size_t k) -> std::uint32_t { return static_cast<std::uint32_t>(begin[k % n]); };
+                auto put = [&](std::size_t k, std::uint32_t x) { begin[k % n] = x; };
+                auto mix = [](std::uint32_t x) { return x ^ (x >> 27); };
+
+                std::fill(begin, end, 0x8b8b8b8bu);
+
+                for (std::size_t k = 0; k < m; ++k)
+                {
+                    const std::uint32_t r1 = 1664525u * mix(at(k) ^ at(k + p) ^ at(k + n - 1));
+                    std::uint32_t r2 = r1;
+                    if (k == 0)
+                        r2 += static_cast<std::uint32_t>(s);
+                    else if (k <= s)
+                        r2 += static_cast<std::uint32_t>(k % n) + v_[k - 1];
+                    else
+                        r2 += static_cast<std::uint32_t>(k % n);
+
+                    put(k + p, at(k + p) + r1);
+                    put(k + q, at(k + q) + r2);
+                    put(k, r2);
+                }
+
+                for (std::size_t k = m; k < m + n; ++k)
+                {
+                    const std::uint32_t r3 = 1566083941u * mix(at(k) + at(k + p) + at(k + n - 1));
+                    const std::uint32_t r4 = r3 - static_cast<std::uint32_t>(k % n);
+
+                    put(k + p, at(k + p) ^ r3);
+                    put(k + q, at(k + q) ^ r4);
+                    put(k, r4);
+                }
+            }
+
+        private:
+            std::uint32_t v_[3];
+        };
+
+        /** @brief Generator of block b: seeded from (seed, b) so any block is reproducible on its own. */
+        std::mt19937_64 block_generator(unsigned long seed, int b)
+        {
+            BlockSeed seq(seed, b);
+            return std::mt19937_64(seq);
+        }
+
+        /**
+         * @brief Inverse of the standard normal CDF (Acklam's rational approximation).
+         *
+         * Relative error below 1.2e-9 on (0, 1), which is far below the Monte Carlo noise.
+         */
+        double inverse_normal_cdf(double p)
+        {
+            static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+            static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                6.680131188771972e+01, -1.328068155288572e+01 };
+            static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+            static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                3.754408661907416e+00 };
+            const double pLow = 0.02425;
+
+            if (p < pLow)
+            {
+                const double q = std::sqrt(-2.0 * std::log(p));
+                return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5])
+                    / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+            }
+
+            if (p > 1.0 - pLow)
+            {
+                const double q = std::sqrt(-2.0 * std::log(1.0 - p));
+                return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5])
+                    / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+            }
 
+            const double q = p - 0.5;
+            const double r = q * q;
+            return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q
+                / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+        }
+
+        /**
+         * @brief Antithetic paths of one block of count paths from its stream of draws.
+         *
+         * Paths go in pairs (i, i+1) with one draw Z and its antithetic counterpart -Z
+         * per step; with an odd count, the last path has no pair. draw() returns the
+         * next value of the stream: the block generator, or the normal store.
+         */
+        template <class Draw, class F>
+        void antithetic_block(int count, int Nt, int base, Draw&& draw, F&& f)
+        {
+            // Use antithetic variates in pairs (i, i+1)
+            int i = 0;
+            for (; i + 1 < count; i += 2)
+            {
+                for (int k = 1; k <= Nt; k++)
+                {
+                    // One Gaussian draw and its antithetic counterpart
+                    double Z = draw();
+                    f(base + i, k, Z);
+                    f(base + i + 1, k, -Z);
+                }
+            }
+
+            // Odd block size: simulate the last path without an antithetic pair
+            if (i < count)
+            {
+                for (int k = 1; k <= Nt; k++)
+                    f(base + i, k, draw());
+            }
+        }
+
+        /**
+         * @brief Draws the standard normals of the paths of blocks [firstBlock, lastBlock).
+         *
+         * Calls f(i, k, Z) for local path i (counted from the first path of
+         * firstBlock) and step k in [1, Nt]. Each block has its own generator,
+         * seeded from (seed, block index), so any slice of blocks is reproduced
+         * without drawing the others. Inside a block, paths are drawn in pairs
+         * (i, i+1) with one Gaussian Z and its antithetic counterpart -Z per step;
+         * if the last block has an odd number of paths, its last path has no pair.
+         */
+        template <class F>
+        void for_each_normal(unsigned long seed, int N, int Nt, int firstBlock, int lastBlock, F&& f)
+        {
+            std::normal_distribution<double> normal(0.0, 1.0);
+
+            for (int b = firstBlock; b < lastBlock; ++b)
+            {
+                std::mt19937_64 gen = block_generator(seed, b);
+                normal.reset();
+
+                const int base = (b - firstBlock) * MonteCarlo::block_size;
+                const int count = std::min(MonteCarlo::block_size, N - b * MonteCarlo::block_size);
+
+                antithetic_block(count, Nt, base, [&]() { return normal(gen); }, f);
+            }
+        }
+
+        /**
+         * @brief Stratified terminal value and Brownian bridge, same contract as for_each_normal().
+         *
+         * Global path g falls in stratum j = g % strata of the terminal standardized
+         * Brownian value xi = Phi^{-1}((j + U) / strata). The walk X_k = Z_1 + ... + Z_k
+         * is then pinned to X_Nt = xi sqrt(Nt) and filled forward by the Brownian bridge:
+         * X_k | X_{k-1} ~ N(X_{k-1} + (X_Nt - X_{k-1}) / (Nt - k + 1), (Nt - k) / (Nt - k + 1)).
+         */
+        template <class F>
+        void for_each_bridge_normal(unsigned long seed, int N, int Nt, int strata, int firstBlock, int lastBlock, F&& f)
+        {
+            std::normal_distribution<double> normal(0.0, 1.0);
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+            const double sqrtNt = std::sqrt(static_cast<double>(Nt));
+
+            for (int b = firstBlock; b < lastBlock; ++b)
+            {
+                std::mt19937_64 gen = block_generator(seed, b);
+                normal.reset();
+
+                const int base = (b - firstBlock) * MonteCarlo::block_size;
+                const int count = std::min(MonteCarlo::block_size, N - b * MonteCarlo::block_size);
+
+                for (int i = 0; i < count; ++i)
+                {
+                    const int stratum = (b * MonteCarlo::block_size + i) % strata;
+                    // (stratum + U) / strata can round to 0 or, in the top stratum, to 1: keep Phi^{-1} finite
+                    const double u = std::min(std::max((stratum + uniform(gen)) / strata, std::numeric_limits<double>::min()),
+                        std::nextafter(1.0, 0.0));
+                    const double XT = inverse_normal_cdf(u) * sqrtNt;
+
+                    double X = 0.0;
+                    for (int k = 1; k < Nt; ++k)
+                    {
+                        const double left = static_cast<double>(Nt - k + 1);
+                        const double next = X + (XT - X) / left + std::sqrt((left - 1.0) / left) * normal(gen);
+                        f(base + i, k, next - X);
+                        X = next;
+                    }
+                    f(base + i, Nt, XT - X);
+                }
+            }
+        }
+    }
+
+    MonteCarlo::MonteCarlo(double t, double T, double S0, double r, double sigma,
+        int N, double dS, int M, const std::string& optionStr, unsigned long seed,
+        const SimulationSettings& settings)
+        : Data(t, T, S0, r, sigma, N, dS, M, optionStr, seed), settings_(settings)
+    {
+        // Time discretization: daily steps between t_ and T_, or the fixing schedule
         build_time_grid();
+
+        check_grid_and_volatility(Nt_, sigma_, settings_.vol_curve.empty());
+
+        if (settings_.shard_count < 1 || settings_.shard_index < 0 || settings_.shard_index >= settings_.shard_count)
+            throw std::invalid_argument("Shard index must be in [0, shard count).");
+
+        if (settings_.block_begin < 0)
+            throw std::invalid_argument("First block must be non-negative.");
+
+        check_sampling(N_, settings_);
+
+        if (is_seasoned())
+        {
+            // The carried-in extreme already includes the current spot
+            const double m = settings_.running_extreme;
+            const bool call = (optionType_ == OptionType::Call);
+            if (!(m > 0.0) || !(S0_ > 0.0) || (call ? m > S0_ : m < S0_))
+                throw std::invalid_argument(call
+                    ? "Running minimum must be positive and not above S0."
+                    : "Running maximum must be positive and not below S0.");
+        }
+
+        for (double v : settings_.vol_curve.get_values())
+            if (v <= 0.0)
+                throw std::invalid_argument("Volatility term structure must be positive.");
+
+        // Contiguous slice of blocks owned by this shard
+        const long long nBlocks = block_count(N_);
+        firstBlock_ = static_cast<int>(nBlocks * settings_.shard_index / settings_.shard_count);
+        lastBlock_ = static_cast<int>(nBlocks * (settings_.shard_index + 1) / settings_.shard_count);
+
+        // Optional restriction to a range of blocks (e.g. one batch of a progressive run)
+        firstBlock_ = std::max(firstBlock_, settings_.block_begin);
+        if (settings_.block_end >= 0)
+            lastBlock_ = std::min(lastBlock_, settings_.block_end);
+        lastBlock_ = std::max(lastBlock_, firstBlock_);
+        firstPath_ = firstBlock_ * block_size;
+        pathCount_ = std::max(0, std::min(N_, lastBlock_ * block_size) - firstPath_);
+
+        build_step_tables();
         simulate_paths();
     }
 
     void MonteCarlo::build_time_grid()
     {
-        timeGrid_.resize(Nt_ + 1);
-        for (int k = 0; k <= Nt_; ++k)
+        const std::vector<double>& fixings = settings_.fixing_dates;
+
+        if (fixings.empty())
+        {
+            dt_ = 1.0 / 252.0;
+            Nt_ = static_cast<int>((T_ - t_) * 252.0);
+
+            timeGrid_.resize(std::max(Nt_, 0) + 1);
+            for (int k = 0; k <= Nt_; ++k)
+            {
+                timeGrid_[k] = t_ + k * dt_;
+            }
+            return;
+        }
+
+        for (size_t j = 0; j < fixings.size(); ++j)
+        {
+            if (!std::isfinite(fixings[j]) || (j > 0 && fixings[j] <= fixings[j - 1]))
+                throw std::invalid_argument("Fixing dates must be finite and strictly increasing.");
+        }
+
+        // Steps only between fixing dates: t_, the fixings inside (t_, T_), then T_.
+        // Fixings already past at t_ are dropped. The grid lives in the arena: exact size up front
+        timeGrid_.reserve(step_count(t_, T_, fixings) + 1);
+        timeGrid_.assign(1, t_);
+        for (double d : fixings)
+        {
+            if (d > t_ && d < T_)
+                timeGrid_.push_back(d);
+        }
+        if (T_ > t_)
+            timeGrid_.push_back(T_);
+
+        Nt_ = static_cast<int>(timeGrid_.size()) - 1;
+        dt_ = (Nt_ > 0) ? (T_ - t_) / Nt_ : 0.0;
+    }
+
+    std::vector<double> MonteCarlo::regular_fixings(double t, double T, double perYear)
+    {
+        if (!(perYear > 0.0) || !std::isfinite(perYear))
+            throw std::invalid_argument("Fixing frequency must be positive.");
+
+        // Dates t + j / perYear strictly before T; the maturity is always a fixing
+        std::vector<double> dates;
+        for (int j = 1; t + j / perYear < T; ++j)
+            dates.push_back(t + j / perYear);
+        return dates;
+    }
+
+    void MonteCarlo::build_step_tables()
+    {
+        drift_.resize(Nt_);
+        diffusion_.resize(Nt_);
+        vol_.resize(Nt_);
+        discount_ = discount_factor(r_, settings_.rate_curve, t_, T_);
+
+        if (!has_term_structure() && !has_fixing_schedule())
         {
-            timeGrid_[k] = t_ + k * dt_;
+            // GBM parameters for one step:
+            // S_{t+dt} = S_t * exp((r - 0.5 sigma^2) dt + sigma sqrt(dt) Z)
+            std::fill(drift_.begin(), drift_.end(), (r_ - 0.5 * sigma_ * sigma_) * dt_);
+            std::fill(diffusion_.begin(), diffusion_.end(), sigma_ * std::sqrt(dt_));
+            std::fill(vol_.begin(), vol_.end(), sigma_ * dt_);
+            return;
+        }
+
+        // Exact GBM step between grid dates, with time-dependent parameters:
+        // S_{k} = S_{k-1} * exp(int (r - 0.5 sigma^2) + sqrt(int sigma^2) Z)
+        const TermStructure& rate = settings_.rate_curve;
+        const TermStructure& vol = settings_.vol_curve;
+
+        for (int k = 1; k <= Nt_; ++k)
+        {
+            const double a = timeGrid_[k - 1];
+            const double b = timeGrid_[k];
+            const double h = b - a;
+
+            const double rateIntegral = rate.empty() ? r_ * h : rate.integral(a, b);
+            const double variance = vol.empty() ? sigma_ * sigma_ * h : vol.integral_sq(a, b);
+
+            drift_[k - 1] = rateIntegral - 0.5 * variance;
+            diffusion_[k - 1] = std::sqrt(variance);
+            vol_[k - 1] = vol.empty() ? sigma_ * h : vol.integral(a, b);
         }
     }
 
     void MonteCarlo::simulate_paths()
     {
-        // Initialize matrix: N_ paths, each with Nt_ + 1 time steps (including S0 at k=0)
-        paths_.assign(N_, std::vector<double>(Nt_ + 1));
+        const auto start = std::chrono::steady_clock::now();
 
-        // GBM parameters for one step:
-        // S_{t+dt} = S_t * exp((r - 0.5 sigma^2) dt + sigma sqrt(dt) Z)
-        const double muTerm = (r_ - 0.5 * sigma_ * sigma_) * dt_;
-        const double sigmaTerm = sigma_ * std::sqrt(dt_);
+        // Per-step coefficients, read by the step kernel
+        const double* drift = drift_.data();
+        const double* diffusion = diffusion_.data();
 
-        
-        std::mt19937_64 gen(seed_);
-        std::normal_distribution<double> normal(0.0, 1.0);
+        // Importance sampling: sum of the shifted increments of each path, for its likelihood ratio
+        const bool shifted = settings_.drift_shift != 0.0;
+        ArenaVector<double> sumZ(shifted ? pathCount_ : 0, 0.0);
 
-        // Use antithetic variates in pairs (i, i+1)
-        int i = 0;
-        for (; i + 1 < N_; i += 2)
+        // Matrix of the stored paths, each with Nt_ + 1 time steps (including S0 at k=0)
+        auto simulate = [&](auto& paths)
         {
-            auto& path1 = paths_[i];
-            auto& path2 = paths_[i + 1];
+            paths.resize(pathCount_, Nt_ + 1);
 
-            // Initial condition
-            path1[0] = S0_;
-            path2[0] = S0_;
+            // The running value of each path is kept in double, whatever the storage
+            ArenaVector<double> current(pathCount_, S0_);
+            for (int i = 0; i < pathCount_; ++i)
+                paths[i][0] = S0_;
 
-            for (int k = 1; k <= Nt_; k++)
+            // Draw the Gaussians in the same order as generate_normals()
+            for_each_increment(firstBlock_, lastBlock_, [&](int i, int k, double Z)
+                {
+                    current[i] *= std::exp(drift[k - 1] + diffusion[k - 1] * Z);
+                    paths[i][k] = current[i];
+                    if (shifted)
+                        sumZ[i] += Z;
+                });
+        };
+
+        if (is_seasoned())
+        {
+            // Seasoned trade: path summaries only, no path matrix
+            paths_.clear();
+            pathsF_.clear();
+            simulate_seasoned(sumZ);
+        }
+        else if (settings_.precision == Precision::Single)
+        {
+            paths_.clear();
+            simulate(pathsF_);
+        }
+        else
+        {
+            pathsF_.clear();
+            simulate(paths_);
+        }
+
+        // Likelihood ratio of the shifted terminal value
+        // xi = (Z_1 + ... + Z_Nt) / sqrt(Nt): dP/dQ = exp(-theta xi + theta^2 / 2)
+        weights_.clear();
+        if (shifted)
+        {
+            const double theta = settings_.drift_shift;
+            const double sqrtNt = std::sqrt(static_cast<double>(Nt_));
+
+            weights_.resize(pathCount_);
+            for (int i = 0; i < pathCount_; ++i)
+                weights_[i] = std::exp(-theta * sumZ[i] / sqrtNt + 0.5 * theta * theta);
+        }
+
+        // Per-node throughput (see Numa.h)
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        record_node_work(static_cast<long long>(pathCount_) * Nt_, elapsed.count());
+    }
+
+    void MonteCarlo::simulate_seasoned(ArenaVector<double>& sumZ)
+    {
+        const double* drift = drift_.data();
+        const double* diffusion = diffusion_.data();
+        const double* vol = vol_.data();
+
+        // Calls beat the extreme from below (new minimum), puts from above (new maximum)
+        const double sign = (optionType_ == OptionType::Call) ? -1.0 : 1.0;
+        const double logExtreme0 = std::log(settings_.running_extreme / S0_);
+
+        // Running state of each path, in log space relative to S0: one FMA per step instead of an exp
+        ArenaVector<double> logS(pathCount_, 0.0), dlogS(pathCount_, 0.0);
+        ArenaVector<double> logExtreme(pathCount_, logExtreme0), dlogExtreme(pathCount_, 0.0);
+        ArenaVector<char> beaten(pathCount_, 0);
+        ArenaVector<double> firstZ(pathCount_, 0.0);
+
+        for_each_increment(firstBlock_, lastBlock_, [&](int i, int k, double Z)
             {
-                // One Gaussian draw and its antithetic counterpart
-                double Z = normal(gen);
-                double Za = -Z;
+                logS[i] += drift[k - 1] + diffusion[k - 1] * Z;
+                if (k == 1)
+                    firstZ[i] = Z;
 
-                double incr1 = muTerm + sigmaTerm * Z;
-                double incr2 = muTerm + sigmaTerm * Za;
+                // d log S_k / dsigma for a parallel shift: sum of A_j (Z_j / sqrt(V_j) - 1)
+                dlogS[i] += vol[k - 1] * (Z / diffusion[k - 1] - 1.0);
 
-                path1[k] = path1[k - 1] * std::exp(incr1);
-                path2[k] = path2[k - 1] * std::exp(incr2);
-            }
+                if (sign * logS[i] > sign * logExtreme[i])
+                {
+                    logExtreme[i] = logS[i];
+                    dlogExtreme[i] = dlogS[i];
+                    beaten[i] = 1;
+                }
+
+                if (!sumZ.empty())
+                    sumZ[i] += Z;
+            });
+
+        // Only S_T, and the extreme of the paths that beat the carried one, leave log space
+        summary_.terminal.resize(pathCount_);
+        summary_.extreme.resize(pathCount_);
+        for (int i = 0; i < pathCount_; ++i)
+        {
+            summary_.terminal[i] = S0_ * std::exp(logS[i]);
+            summary_.extreme[i] = beaten[i] ? S0_ * std::exp(logExtreme[i]) : settings_.running_extreme;
         }
+        summary_.beaten = std::move(beaten);
+        summary_.dlog_terminal = std::move(dlogS);
+        summary_.dlog_extreme = std::move(dlogExtreme);
+        summary_.first_increment = std::move(firstZ);
+    }
 
-        // If N_ is odd, simulate the last path without an antithetic pair
-        if (i < N_)
+    template <class F>
+    void MonteCarlo::for_each_increment(int firstBlock, int lastBlock, F&& f) const
+    {
+        // Importance sampling shifts every increment: xi moves by theta
+        const double shift = settings_.drift_shift / std::sqrt(static_cast<double>(Nt_));
+        auto shifted = [&](int i, int k, double Z) { f(i, k, Z + shift); };
+
+        // Warm normal store: the stream is read from the shared mapping, no RNG
+        std::unique_ptr<NormalStore> store;
+        if (!settings_.normal_store.empty())
+            store = open_normal_store();
+
+        // One block at a time, polling the cancellation between blocks
+        for (int b = firstBlock; b < lastBlock; ++b)
         {
-            int last = N_ - 1;
-            auto& path = paths_[last];
-            path[0] = S0_;
+            throw_if_stop_requested();
+
+            const int base = (b - firstBlock) * block_size;
+            auto local = [&](int i, int k, double Z) { shifted(base + i, k, Z); };
 
-            for (int k = 1; k <= Nt_; k++)
+            if (store)
             {
-                double Z = normal(gen);
-                double incr = muTerm + sigmaTerm * Z;
-                path[k] = path[k - 1] * std::exp(incr);
+                const double* stream = store->block(b);
+                const int count = std::min(block_size, N_ - b * block_size);
+                antithetic_block(count, Nt_, 0, [&]() { return *stream++; }, local);
             }
+            else if (settings_.sampling == Sampling::Stratified)
+                for_each_bridge_normal(seed_, N_, Nt_, settings_.strata, b, b + 1, local);
+            else
+                for_each_normal(seed_, N_, Nt_, b, b + 1, local);
+        }
+    }
+
+    std::unique_ptr<NormalStore> MonteCarlo::open_normal_store() const
+    {
+        const NormalStoreKey key{ normal_generator_id, seed_, N_, Nt_, dt_ };
+        const std::string path = NormalStore::file_name(settings_.normal_store, key);
+
+        // Cold store (or stale file): draw the whole stream once and publish it
+        return NormalStore::open_or_create(path, key, block_size, [&](int b, double* out)
+            {
+                std::mt19937_64 gen = block_generator(seed_, b);
+                std::normal_distribution<double> normal(0.0, 1.0);
+                const int count = std::min(block_size, N_ - b * block_size);
+
+                const size_t n = static_cast<size_t>((count + 1) / 2) * Nt_;
+                for (size_t j = 0; j < n; ++j)
+                    out[j] = normal(gen);
+            });
+    }
+
+    void MonteCarlo::check_grid_and_volatility(int Nt, double sigma, bool flatVol)
+    {
+        if (Nt <= 0)
+            throw std::invalid_argument(
+                "Invalid time domain: T must be larger than t by at least 1 day.");
+
+        // The pathwise Vega divides by sigma
+        if (flatVol && !(sigma > 0.0))
+            throw std::invalid_argument("sigma must be positive.");
+    }
+
+    void MonteCarlo::check_sampling(int N, const SimulationSettings& settings)
+    {
+        if (settings.sampling == Sampling::Stratified)
+        {
+            // Power of two dividing block_size, and N a multiple of it: every stratum
+            // gets exactly N / strata paths (proportional allocation, plain mean unbiased)
+            const int K = settings.strata;
+            if (K < 1 || K > block_size || (K & (K - 1)) != 0)
+                throw std::invalid_argument("Number of strata must be a power of two not larger than 1024.");
+            if (N % K != 0)
+                throw std::invalid_argument("N must be a multiple of the number of strata.");
         }
+
+        if (!settings.normal_store.empty() && settings.sampling != Sampling::Antithetic)
+            throw std::invalid_argument("The normal store only holds antithetic streams.");
+
+        if (!std::isfinite(settings.drift_shift))
+            throw std::invalid_argument("Drift shift must be finite.");
+    }
+
+    void MonteCarlo::throw_if_stop_requested() const
+    {
+        if (settings_.cancellation)
+            settings_.cancellation->throw_if_stop_requested();
+    }
+
+    void MonteCarlo::generate_normals(std::vector<double>& Z) const
+    {
+        Z.resize(static_cast<size_t>(pathCount_) * Nt_);
+
+        for_each_increment(firstBlock_, lastBlock_, [&](int i, int k, double z)
+            {
+                Z[static_cast<size_t>(i) * Nt_ + (k - 1)] = z;
+            });
     }
 
-    const std::vector<std::vector<double>>& MonteCarlo::get_paths() const
+    void MonteCarlo::generate_block_normals(int b, std::vector<double>& Z) const
+    {
+        if (b < firstBlock_ || b >= lastBlock_)
+            throw std::out_of_range("Block outside the paths of this run.");
+
+        const int count = std::min(block_size, N_ - b * block_size);
+        Z.resize(static_cast<size_t>(count) * Nt_);
+
+        for_each_increment(b, b + 1, [&](int i, int k, double z)
+            {
+                Z[static_cast<size_t>(i) * Nt_ + (k - 1)] = z;
+            });
+    }
+
+    const PathMatrix<double>& MonteCarlo::get_paths() const
     {
         return paths_;
     }
 
-    const std::vector<double>& MonteCarlo::get_time_grid() const
+    const PathMatrix<float>& MonteCarlo::get_paths_f() const
+    {
+        return pathsF_;
+    }
+
+    int MonteCarlo::step_count(double t, double T, const std::vector<double>& fixings)
+    {
+        if (fixings.empty())
+            return static_cast<int>((T - t) * 252.0);
+
+        const long inside = std::count_if(fixings.begin(), fixings.end(), [&](double d) { return d > t && d < T; });
+        return static_cast<int>(inside) + (T > t ? 1 : 0);
+    }
+
+    int MonteCarlo::block_count(int N)
+    {
+        return (N + block_size - 1) / block_size;
+    }
+
+    void MonteCarlo::block_normals(unsigned long seed, int N, int Nt, int b, double* Z, int stride)
+    {
+        for_each_normal(seed, N, Nt, b, b + 1, [&](int i, int k, double z)
+            {
+                Z[static_cast<size_t>(k - 1) * stride + i] = z;
+            });
+    }
+
+    void MonteCarlo::block_normals(unsigned long seed, int N, int Nt, const SimulationSettings& settings,
+        int b, double* Z, int stride)
+    {
+        auto store = [&](int i, int k, double z)
+            {
+                Z[static_cast<size_t>(k - 1) * stride + i] = z;
+            };
+
+        // A normal store only caches the antithetic stream: drawing it again gives the same values
+        if (settings.sampling == Sampling::Stratified)
+            for_each_bridge_normal(seed, N, Nt, settings.strata, b, b + 1, store);
+        else
+            for_each_normal(seed, N, Nt, b, b + 1, store);
+    }
+
+    int MonteCarlo::get_first_block() const
+    {
+        return firstBlock_;
+    }
+
+    int MonteCarlo::get_local_block_count() const
+    {
+        return lastBlock_ - firstBlock_;
+    }
+
+    int MonteCarlo::get_first_path() const
+    {
+        return firstPath_;
+    }
+
+    int MonteCarlo::get_path_count() const
+    {
+        return pathCount_;
+    }
+
+    const ArenaVector<double>& MonteCarlo::get_weights() const
+    {
+        return weights_;
+    }
+
+    bool MonteCarlo::has_term_structure() const
+    {
+        return !settings_.rate_curve.empty() || !settings_.vol_curve.empty();
+    }
+
+    bool MonteCarlo::is_seasoned() const
+    {
+        return !std::isnan(settings_.running_extreme);
+    }
+
+    const PathSummary& MonteCarlo::get_path_summary() const
+    {
+        return summary_;
+    }
+
+    bool MonteCarlo::has_fixing_schedule() const
+    {
+        return !settings_.fixing_dates.empty();
+    }
+
+    const ArenaVector<double>& MonteCarlo::get_drift_table() const
+    {
+        return drift_;
+    }
+
+    const ArenaVector<double>& MonteCarlo::get_diffusion_table() const
+    {
+        return diffusion_;
+    }
+
+    const ArenaVector<double>& MonteCarlo::get_vol_table() const
+    {
+        return vol_;
+    }
+
+    double MonteCarlo::get_discount() const
+    {
+        return discount_;
+    }
+
+    const SimulationSettings& MonteCarlo::get_settings() const
+    {
+        return settings_;
+    }
+
+    const ArenaVector<double>& MonteCarlo::get_time_grid() const
     {
         return timeGrid_;
     }
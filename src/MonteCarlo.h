@@ -1,17 +1,166 @@
 #pragma once
 #include "data.h"
+#include "PathMatrix.h"
+#include "TermStructure.h"
+#include "Cancellation.h"
+#include "NormalStore.h"
+#include <cstdint>
+#include <limits>
+#include <memory>
 
 namespace ensiie
 {
+    /** @brief Storage precision of the simulated paths. */
+    enum class Precision
+    {
+        Double,   ///< double paths (default)
+        Single    ///< float path storage: half the bytes; the GBM step stays in double (see simulate_paths())
+    };
+
+    /** @brief Sampling scheme of the driving Gaussians. */
+    enum class Sampling
+    {
+        Antithetic,   ///< Step-by-step Gaussians in antithetic pairs (default)
+        Stratified    ///< Stratified terminal Brownian value, path filled by a Brownian bridge
+    };
+
+    /**
+     * @brief Optional simulation settings, shared by MonteCarlo and the pricers.
+     *
+     * Default-constructed settings reproduce the original engine.
+     */
+    struct SimulationSettings
+    {
+        /** @brief Storage precision of the paths. Estimators always accumulate in double. */
+        Precision precision = Precision::Double;
+
+        /** @brief Index of the shard simulated by this process, in [0, shard_count). */
+        int shard_index = 0;
+
+        /** @brief Number of shards the path blocks are split into. */
+        int shard_count = 1;
+
+        /** @brief First block to simulate (blocks outside the shard slice are ignored). */
+        int block_begin = 0;
+
+        /** @brief One past the last block to simulate, or -1 for the end of the shard slice. */
+        int block_end = -1;
+
+        /** @brief Sampling scheme of the driving Gaussians. */
+        Sampling sampling = Sampling::Antithetic;
+
+        /** @brief Number of strata of the terminal value (Stratified only): power of two dividing N and 1024. */
+        int strata = 64;
+
+        /**
+         * @brief Importance sampling shift theta of the standardized terminal Brownian value.
+         *
+         * 0 disables importance sampling. Otherwise each path carries the likelihood
+         * ratio exp(-theta xi + theta^2 / 2), applied by the Pricing estimators.
+         */
+        double drift_shift = 0.0;
+
+        /**
+         * @brief Risk-free rate term structure r(t). Empty: flat rate r.
+         *
+         * Drives the GBM drift and the discounting; Rho is then the sensitivity
+         * to a parallel shift of the curve.
+         */
+        TermStructure rate_curve;
+
+        /**
+         * @brief Volatility term structure sigma(t). Empty: flat volatility sigma.
+         *
+         * Vega is then the sensitivity to a parallel shift of the curve.
+         */
+        TermStructure vol_curve;
+
+        /**
+         * @brief Monitoring schedule: fixing dates, strictly increasing. Empty: daily grid.
+         *
+         * The paths step exactly from fixing to fixing (t, the fixings inside (t, T),
+         * then T), so the extremes are taken on the contract's fixing calendar and a
+         * monthly-fixing trade costs 12 steps a year.
+         */
+        std::vector<double> fixing_dates;
+
+        /**
+         * @brief Extreme observed since inception of a seasoned trade (running minimum
+         * for a call, running maximum for a put). NaN: fresh trade.
+         *
+         * The payoff extreme is then taken over this value and the simulated path.
+         * Paths are walked in log space and only summarized (see PathSummary):
+         * no path matrix is stored.
+         */
+        double running_extreme = std::numeric_limits<double>::quiet_NaN();
+
+        /**
+         * @brief Cancellation flag and deadline of the request. Null: never stops.
+         *
+         * Polled once per block by the simulation and once per reduction by the
+         * estimators, which then throw Cancelled. Bumped runs share it.
+         */
+        std::shared_ptr<const CancellationToken> cancellation;
+
+        /**
+         * @brief Directory of the persistent normal store (see NormalStore). Empty: none.
+         *
+         * Antithetic runs then read their Gaussians from a memory-mapped file keyed by
+         * (generator, seed, N, Nt, dt), created by the first run of that key; later
+         * runs, in this process or others, skip the random number generation. The
+         * paths are bit-identical with or without the store.
+         */
+        std::string normal_store;
+    };
+
+    /**
+     * @brief Per-path summary of a seasoned run: all the lookback estimators need.
+     *
+     * Paths that never beat the carried-in extreme reduce to S_T.
+     */
+    struct PathSummary
+    {
+        ArenaVector<double> terminal;        ///< S_T
+        ArenaVector<double> extreme;         ///< Extreme over the carried-in value and the path
+        ArenaVector<char> beaten;            ///< 1 if the path beat the carried-in extreme
+        ArenaVector<double> dlog_terminal;   ///< Pathwise d log S_T / dsigma (parallel shift)
+        ArenaVector<double> dlog_extreme;    ///< Pathwise d log S_ext / dsigma (0 if not beaten)
+        ArenaVector<double> first_increment; ///< Standardized increment Z_1 of the first step (spot score)
+    };
+
     /**
      * @brief Monte Carlo simulator for GBM paths with antithetic variates.
      *
      * Inherits market parameters from Data.
      * Stores N_ paths, each of length Nt_ + 1 (including the initial time).
+     *
+     * The path index space is cut into blocks of block_size paths, each drawn
+     * from its own generator seeded from (seed, block). A sharded object, or one
+     * restricted to [block_begin, block_end), only simulates its contiguous slice
+     * of blocks; the paths it stores are then exactly the corresponding rows of
+     * the full run.
+     *
+     * All buffers (paths, step tables, summaries) come from the arena current at
+     * construction (see Arena.h), and the object must not outlive it.
      */
     class MonteCarlo : public Data
     {
     public:
+        /**
+         * @brief Identifier of the normal stream written to normal stores: mt19937_64
+         * seeded per block, then std::normal_distribution, which differs between
+         * standard libraries (hence one identifier per library).
+         */
+#if defined(__GLIBCXX__)
+        static constexpr std::uint32_t normal_generator_id = 0x101;
+#elif defined(_MSC_VER)
+        static constexpr std::uint32_t normal_generator_id = 0x102;
+#else
+        static constexpr std::uint32_t normal_generator_id = 0x103;
+#endif
+
+        /** @brief Number of paths per random-number block (even, so antithetic pairs never straddle blocks). */
+        static constexpr int block_size = 1024;
 
         /**
          * @brief Constructor.
@@ -19,35 +168,227 @@ namespace ensiie
          * Builds the time grid and immediately simulates the paths.
          */
         MonteCarlo(double t, double T, double S0, double r, double sigma,
-            int N, double dS, int M, const std::string& optionStr, unsigned long seed);
+            int N, double dS, int M, const std::string& optionStr, unsigned long seed,
+            const SimulationSettings& settings = SimulationSettings());
 
         /**
-         * @brief (Re)simulate all GBM paths using antithetic variates.
+         * @brief (Re)simulate all GBM paths (antithetic variates, or stratified
+         * terminal value and Brownian bridge).
          *
-         * Paths are stored in a matrix of size N_ x (Nt_ + 1).
+         * Paths are stored in a matrix of size get_path_count() x (Nt_ + 1).
          * Row i is the i-th path, column k is time step k.
+         * The GBM recursion runs in double; in Precision::Single mode the values
+         * are rounded to float when stored. The cost is in drawing the Gaussians,
+         * so a float recursion gains nothing measurable while its rounding error
+         * grows with the number of steps: single precision saves memory, not time.
          */
         void simulate_paths();
 
-        /** @brief Returns the matrix of simulated paths. */
-        const std::vector<std::vector<double>>& get_paths() const;
+        /**
+         * @brief Writes the standard normals driving the paths into Z.
+         *
+         * Z has size get_path_count() x Nt_ (row-major): Z[i * Nt_ + k - 1] is the
+         * Gaussian of local path i at step k, antithetic pairs (or Brownian bridge) and
+         * importance sampling shift included. It is the exact stream used
+         * by simulate_paths(), so engines can reuse it as common random numbers.
+         */
+        void generate_normals(std::vector<double>& Z) const;
+
+        /**
+         * @brief Writes the standard normals of block b into Z: the rows of
+         * generate_normals() for the paths of that block only.
+         *
+         * Z has size count x Nt_ for the count paths of the block, so engines can
+         * stream the common random numbers block by block instead of holding
+         * the whole get_path_count() x Nt_ matrix. Throws std::out_of_range if
+         * b is not a block of this object.
+         */
+        void generate_block_normals(int b, std::vector<double>& Z) const;
+
+        /** @brief Returns true if a carried-in running extreme is set (seasoned trade). */
+        bool is_seasoned() const;
+
+        /** @brief Returns the path summaries of a seasoned run (empty otherwise). */
+        const PathSummary& get_path_summary() const;
+
+        /** @brief Returns the matrix of simulated paths (empty in Precision::Single mode). */
+        const PathMatrix<double>& get_paths() const;
+
+        /** @brief Returns the matrix of single-precision paths (empty in Precision::Double mode). */
+        const PathMatrix<float>& get_paths_f() const;
+
+        /**
+         * @brief Calls f with the path matrix of the active precision.
+         *
+         * f is a generic callable taking a const PathMatrix<T>&, so estimator
+         * loops are instantiated once per storage type.
+         */
+        template <class F>
+        decltype(auto) visit_paths(F&& f) const
+        {
+            if (settings_.precision == Precision::Single)
+                return f(pathsF_);
+            return f(paths_);
+        }
+
+        /**
+         * @brief Number of time steps of a run over [t, T]: daily, or the fixing dates
+         * inside (t, T) plus the maturity. Same grid as the constructor builds.
+         */
+        static int step_count(double t, double T, const std::vector<double>& fixings);
+
+        /**
+         * @brief Checks of the constructor on the grid and volatility, shared with
+         * BatchEngine so a batch lane and a single run accept the same trades.
+         *
+         * Throws std::invalid_argument if the grid has no step (T - t under one day)
+         * or, with a flat volatility, if sigma is not positive.
+         * @param Nt Number of time steps of the grid.
+         * @param sigma Flat volatility.
+         * @param flatVol False with a volatility term structure (checked on its own).
+         */
+        static void check_grid_and_volatility(int Nt, double sigma, bool flatVol);
+
+        /**
+         * @brief Checks of the constructor on the sampling settings, shared with
+         * ScenarioEngine: strata (a power of two dividing N and block_size), normal
+         * store with antithetic sampling only, finite drift shift.
+         * Throws std::invalid_argument otherwise.
+         */
+        static void check_sampling(int N, const SimulationSettings& settings);
+
+        /** @brief Number of blocks of a run of N paths. */
+        static int block_count(int N);
+
+        /**
+         * @brief Writes the antithetic standard normals of block b of a run, step-major.
+         *
+         * Z[(k - 1) * stride + i] is the Gaussian of path i of the block at step k:
+         * the stream simulate_paths() uses with default settings, for engines that
+         * lay paths out differently (see BatchEngine).
+         * @param seed Seed of the run.
+         * @param N Number of paths of the run.
+         * @param Nt Number of time steps.
+         * @param b Block index.
+         * @param Z Output, at least Nt rows of stride values.
+         * @param stride Row length of Z (at least the number of paths of the block).
+         */
+        static void block_normals(unsigned long seed, int N, int Nt, int b, double* Z, int stride);
+
+        /**
+         * @brief As above, for the sampling scheme of settings (antithetic, or stratified
+         * terminal value and Brownian bridge), without the importance sampling shift:
+         * the rows of generate_block_normals() for a run that is never simulated.
+         */
+        static void block_normals(unsigned long seed, int N, int Nt, const SimulationSettings& settings,
+            int b, double* Z, int stride);
+
+        /** @brief Returns the index of the first block simulated by this object. */
+        int get_first_block() const;
+
+        /** @brief Returns the number of blocks simulated by this object. */
+        int get_local_block_count() const;
+
+        /** @brief Returns the global index of the first stored path. */
+        int get_first_path() const;
+
+        /** @brief Returns the number of stored paths (N_ unless sharded). */
+        int get_path_count() const;
+
+        /** @brief Returns the likelihood-ratio weight of each stored path (empty without importance sampling). */
+        const ArenaVector<double>& get_weights() const;
+
+        /** @brief Returns the simulation settings. */
+        const SimulationSettings& get_settings() const;
 
         /** @brief Returns the time grid (Nt_ + 1 points from t_ to T_). */
-        const std::vector<double>& get_time_grid() const;
+        const ArenaVector<double>& get_time_grid() const;
 
         /** @brief Returns the number of time steps (excluding initial). */
         int get_Nt() const;
 
-        /** @brief Returns the time step size (dt). */
+        /** @brief Returns the time step size (dt); the mean step with a fixing schedule. */
         double get_dt() const;
 
+        /** @brief Returns true if a rate or volatility term structure is set. */
+        bool has_term_structure() const;
+
+        /** @brief Returns true if the time grid follows a fixing schedule (non-uniform steps). */
+        bool has_fixing_schedule() const;
+
+        /**
+         * @brief Regular fixing calendar of perYear dates a year from t (maturity excluded).
+         * @param t Initial time.
+         * @param T Maturity time.
+         * @param perYear Number of fixings per year (e.g. 12 for monthly, 52 for weekly).
+         */
+        static std::vector<double> regular_fixings(double t, double T, double perYear);
+
+        /** @brief Log drift of each step: integral of r - sigma^2 / 2 over [t_{k-1}, t_k], index k - 1. */
+        const ArenaVector<double>& get_drift_table() const;
+
+        /** @brief Diffusion of each step: sqrt of the integral of sigma^2 over the step. */
+        const ArenaVector<double>& get_diffusion_table() const;
+
+        /** @brief Integral of sigma over each step (parallel-shift derivative of the step variance / 2). */
+        const ArenaVector<double>& get_vol_table() const;
+
+        /** @brief Returns the discount factor from t to T. */
+        double get_discount() const;
+
+    protected:
+        /** @brief Simulation settings. */
+        const SimulationSettings settings_;
+
+        /** @brief Throws Cancelled if the request was cancelled or its deadline passed. */
+        void throw_if_stop_requested() const;
+
     private:
         int Nt_;                           ///< Number of time steps (e.g. days)
         double dt_;                        ///< Time step size (e.g. 1/365)
-        std::vector<double> timeGrid_;     ///< Time grid of size Nt_ + 1
-        std::vector<std::vector<double>> paths_; ///< N_ x (Nt_ + 1) matrix
+        ArenaVector<double> timeGrid_;     ///< Time grid of size Nt_ + 1
+        PathMatrix<double> paths_;         ///< N_ x (Nt_ + 1) matrix (double mode)
+        PathMatrix<float> pathsF_;         ///< N_ x (Nt_ + 1) matrix (single mode)
+        int firstBlock_;                   ///< First block of this shard
+        int lastBlock_;                    ///< One past the last block of this shard
+        int firstPath_;                    ///< Global index of the first stored path
+        int pathCount_;                    ///< Number of stored paths
+        ArenaVector<double> weights_;      ///< Likelihood ratio per stored path (importance sampling)
+        PathSummary summary_;              ///< Path summaries (seasoned runs only)
+        ArenaVector<double> drift_;        ///< Log drift per step
+        ArenaVector<double> diffusion_;    ///< Diffusion coefficient per step
+        ArenaVector<double> vol_;          ///< Integral of sigma per step
+        double discount_;                  ///< Discount factor from t_ to T_
 
-        /** @brief Build the time grid from t_ to T_ using dt_. */
+        /** @brief Build the time grid from t_ to T_ (daily, or the fixing schedule) and set Nt_ and dt_. */
         void build_time_grid();
+
+        /**
+         * @brief Precompute the per-step coefficients from r, sigma or their term structures.
+         *
+         * Done once per object, so the step loop of simulate_paths() costs the same
+         * with curves as with flat parameters.
+         */
+        void build_step_tables();
+
+        /**
+         * @brief Walks the paths in log space against the carried-in extreme and fills summary_.
+         * @param sumZ Per-path sum of the increments (importance sampling), or empty.
+         */
+        void simulate_seasoned(ArenaVector<double>& sumZ);
+
+        /**
+         * @brief Calls f(i, k, Z) with the driving standardized increment of every
+         * path i and step k of blocks [firstBlock, lastBlock), for the configured
+         * sampling scheme and shift; i counts from the first path of firstBlock.
+         */
+        template <class F>
+        void for_each_increment(int firstBlock, int lastBlock, F&& f) const;
+
+        /**
+         * @brief Maps the normal store of this run, writing it first if it is missing
+         * or does not match (e.g. left by another generator).
+         */
+        std::unique_ptr<NormalStore> open_normal_store() const;
     };
 }
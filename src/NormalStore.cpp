@@ -0,0 +1,263 @@
+#include "NormalStore.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ensiie
+{
+    namespace
+    {
+        const char magic[8] = { 'L', 'B', 'K', 'N', 'O', 'R', 'M', '\0' };
+
+        /** @brief Header of a store file (64 bytes). */
+        struct Header
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t generator;
+            std::uint64_t seed;
+            std::uint32_t N;
+            std::uint32_t Nt;
+            double dt;
+            std::uint32_t blockSize;
+            std::uint32_t reserved;
+            std::uint64_t count;
+            unsigned char padding[8];
+        };
+
+        static_assert(sizeof(Header) == NormalStore::header_size, "Store header must be 64 bytes.");
+
+        Header make_header(const NormalStoreKey& key, int blockSize)
+        {
+            Header h;
+            std::memset(&h, 0, sizeof(h));
+            std::memcpy(h.magic, magic, sizeof(magic));
+            h.version = NormalStore::version;
+            h.generator = key.generator;
+            h.seed = key.seed;
+            h.N = static_cast<std::uint32_t>(key.N);
+            h.Nt = static_cast<std::uint32_t>(key.Nt);
+            h.dt = key.dt;
+            h.blockSize = static_cast<std::uint32_t>(blockSize);
+            h.count = NormalStore::value_count(key.N, key.Nt, blockSize);
+            return h;
+        }
+
+        int process_id()
+        {
+#ifdef _WIN32
+            return _getpid();
+#else
+            return static_cast<int>(getpid());
+#endif
+        }
+
+        /** @brief Temporary file name of a write to path, unique to the process and the call. */
+        std::string temporary_name(const std::string& path)
+        {
+            static std::atomic<unsigned> counter{ 0 };
+            return path + ".tmp" + std::to_string(process_id()) + "_" + std::to_string(counter++);
+        }
+
+        /** @brief Mutex serializing the creation of the store at path in this process. */
+        std::mutex& creation_mutex(const std::string& path)
+        {
+            static std::mutex guard;
+            static std::map<std::string, std::mutex> mutexes;   // Nodes are stable: one per store file
+
+            std::lock_guard<std::mutex> lock(guard);
+            return mutexes[path];
+        }
+    }
+
+    NormalStore::NormalStore(const std::string& path, const NormalStoreKey& key, int blockSize)
+        : Nt_(key.Nt), blockSize_(blockSize)
+    {
+        const Header expected = make_header(key, blockSize);
+        const std::size_t expectedSize = header_size + expected.count * sizeof(double);
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Cannot open normal store: " + path);
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || static_cast<std::size_t>(size.QuadPart) != expectedSize) {
+            CloseHandle(file);
+            throw std::runtime_error("Normal store does not match the run: " + path);
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            if (mapping)
+                CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("Cannot map normal store: " + path);
+        }
+
+        file_ = file;
+        mapping_ = mapping;
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Cannot open normal store: " + path);
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) != expectedSize) {
+            close(fd);
+            throw std::runtime_error("Normal store does not match the run: " + path);
+        }
+
+        // Shared read-only mapping: concurrent processes read the same page cache
+        void* view = mmap(nullptr, expectedSize, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (view == MAP_FAILED)
+            throw std::runtime_error("Cannot map normal store: " + path);
+
+        // The simulation walks the stream front to back
+        madvise(view, expectedSize, MADV_SEQUENTIAL);
+#endif
+
+        data_ = static_cast<const unsigned char*>(view);
+        size_ = expectedSize;
+
+        if (std::memcmp(data_, &expected, header_size) != 0) {
+            unmap();
+            throw std::runtime_error("Normal store does not match the run: " + path);
+        }
+    }
+
+    NormalStore::~NormalStore()
+    {
+        unmap();
+    }
+
+    void NormalStore::unmap()
+    {
+        if (!data_)
+            return;
+
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(static_cast<HANDLE>(mapping_));
+        CloseHandle(static_cast<HANDLE>(file_));
+#else
+        munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+        data_ = nullptr;
+    }
+
+    const double* NormalStore::block(int b) const
+    {
+        const std::size_t offset = static_cast<std::size_t>(b) * ((blockSize_ + 1) / 2) * Nt_;
+        return reinterpret_cast<const double*>(data_ + header_size) + offset;
+    }
+
+    std::size_t NormalStore::value_count(int N, int Nt, int blockSize)
+    {
+        const std::size_t fullBlocks = static_cast<std::size_t>(N / blockSize);
+        const int last = N % blockSize;
+        return (fullBlocks * ((blockSize + 1) / 2) + (last + 1) / 2) * static_cast<std::size_t>(Nt);
+    }
+
+    std::string NormalStore::file_name(const std::string& dir, const NormalStoreKey& key)
+    {
+        // dt in exact hexadecimal form, so runs differing in the last bit never share a file
+        char dt[32];
+        std::snprintf(dt, sizeof(dt), "%a", key.dt);
+
+        std::ostringstream name;
+        name << dir;
+        if (!dir.empty() && dir.back() != '/' && dir.back() != '\\')
+            name << '/';
+        name << "normals_g" << key.generator << "_s" << key.seed << "_n" << key.N
+            << "_t" << key.Nt << "_dt" << dt << ".bin";
+        return name.str();
+    }
+
+    void NormalStore::write(const std::string& path, const NormalStoreKey& key, int blockSize,
+        const std::function<void(int, double*)>& fill)
+    {
+        const Header header = make_header(key, blockSize);
+        const std::string temporary = temporary_name(path);
+
+        std::FILE* file = std::fopen(temporary.c_str(), "wb");
+        if (!file)
+            throw std::runtime_error("Cannot write normal store: " + temporary);
+
+        bool ok = std::fwrite(&header, header_size, 1, file) == 1;
+
+        // One block at a time: the store may be much larger than memory
+        const int nBlocks = (key.N + blockSize - 1) / blockSize;
+        std::vector<double> values(static_cast<std::size_t>((blockSize + 1) / 2) * key.Nt);
+        for (int b = 0; ok && b < nBlocks; ++b)
+        {
+            const int count = std::min(blockSize, key.N - b * blockSize);
+            const std::size_t n = static_cast<std::size_t>((count + 1) / 2) * key.Nt;
+            fill(b, values.data());
+            ok = std::fwrite(values.data(), sizeof(double), n, file) == n;
+        }
+
+        ok = (std::fclose(file) == 0) && ok;
+
+        if (!ok) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Cannot write normal store: " + path);
+        }
+
+        // Readers only ever see a complete file. If the rename fails because another
+        // process published the same store first (Windows), that store is kept.
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            std::FILE* existing = std::fopen(path.c_str(), "rb");
+            if (!existing)
+                throw std::runtime_error("Cannot write normal store: " + path);
+            std::fclose(existing);
+        }
+    }
+
+    std::unique_ptr<NormalStore> NormalStore::open_or_create(const std::string& path, const NormalStoreKey& key,
+        int blockSize, const std::function<void(int, double*)>& fill)
+    {
+        // Warm store: no lock
+        try
+        {
+            return std::make_unique<NormalStore>(path, key, blockSize);
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+
+        // Cold store (or stale file): one writer per path, the other tasks map its result
+        std::lock_guard<std::mutex> lock(creation_mutex(path));
+        try
+        {
+            return std::make_unique<NormalStore>(path, key, blockSize);
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+
+        write(path, key, blockSize, fill);
+        return std::make_unique<NormalStore>(path, key, blockSize);
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace ensiie
+{
+    /** @brief Key of a stored normal stream: the run inputs that determine its Gaussians. */
+    struct NormalStoreKey
+    {
+        std::uint32_t generator;   ///< Generator identifier (engine, seeding and normal distribution)
+        unsigned long seed;        ///< Seed of the run
+        int N;                     ///< Number of paths of the run
+        int Nt;                    ///< Number of time steps
+        double dt;                 ///< Time step (mean step with a fixing schedule)
+    };
+
+    /**
+     * @brief Read-only memory map of the antithetic normal stream of a run, shared
+     * through the page cache by concurrent pricer processes.
+     *
+     * The file holds, block after block, the Gaussians in the order the generator
+     * draws them: one per antithetic pair (and per unpaired last path) and step,
+     * i.e. ceil(count / 2) x Nt values for a block of count paths. Layout (native
+     * byte order, checked by the header):
+     *   - "LBKNORM\0", uint32 version, uint32 generator, uint64 seed, uint32 N,
+     *     uint32 Nt, float64 dt, uint32 block size, uint32 0, uint64 value count,
+     *     padded to 64 bytes;
+     *   - the values as float64.
+     *
+     * Pages are only read in when the simulation touches them, sequentially.
+     */
+    class NormalStore
+    {
+    public:
+        /** @brief Format version written in the header. */
+        static constexpr std::uint32_t version = 1;
+
+        /** @brief Bytes before the first value. */
+        static constexpr std::size_t header_size = 64;
+
+        /**
+         * @brief Maps the store at path read-only.
+         *
+         * Throws std::runtime_error if the file cannot be mapped or does not hold
+         * the stream of key (other run, other generator, truncated file).
+         * @param path File of the store.
+         * @param key Run the stream must belong to.
+         * @param blockSize Paths per block of the run.
+         */
+        NormalStore(const std::string& path, const NormalStoreKey& key, int blockSize);
+
+        /** @brief Unmaps the file. */
+        ~NormalStore();
+
+        NormalStore(const NormalStore&) = delete;
+        NormalStore& operator=(const NormalStore&) = delete;
+
+        /** @brief First value of block b. */
+        const double* block(int b) const;
+
+        /** @brief Number of values of a run of N paths, Nt steps and blocks of blockSize paths. */
+        static std::size_t value_count(int N, int Nt, int blockSize);
+
+        /** @brief File name of the store of key in directory dir (one file per key). */
+        static std::string file_name(const std::string& dir, const NormalStoreKey& key);
+
+        /**
+         * @brief Writes the store of key to path.
+         *
+         * fill(b, out) writes the values of block b. The file is written under a
+         * temporary name unique to the process and the call, then renamed, so
+         * concurrent readers never see it half-written.
+         */
+        static void write(const std::string& path, const NormalStoreKey& key, int blockSize,
+            const std::function<void(int, double*)>& fill);
+
+        /**
+         * @brief Maps the store of key at path, writing it with fill first if it is
+         * missing or stale.
+         *
+         * Creation is serialized per path inside the process: concurrent tasks of one
+         * run asking for the same cold store write it once, the others wait and map it.
+         */
+        static std::unique_ptr<NormalStore> open_or_create(const std::string& path, const NormalStoreKey& key,
+            int blockSize, const std::function<void(int, double*)>& fill);
+
+    private:
+        /** @brief Releases the mapping, if any. */
+        void unmap();
+
+        const unsigned char* data_ = nullptr;   ///< Start of the mapping (header included)
+        std::size_t size_ = 0;                  ///< Bytes mapped
+        int Nt_;
+        int blockSize_;
+#ifdef _WIN32
+        void* file_ = nullptr;                  ///< File handle
+        void* mapping_ = nullptr;               ///< File mapping handle
+#endif
+    };
+}
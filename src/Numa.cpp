@@ -0,0 +1,163 @@
+#include "Numa.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace ensiie
+{
+    namespace
+    {
+        /** @brief Largest node index looked up in sysfs. */
+        const int maxNodes = 64;
+
+        thread_local int threadNode = 0;
+
+        /** @brief Parses a sysfs CPU list such as "0-3,8,10-11". */
+        std::vector<int> parse_cpu_list(const std::string& text)
+        {
+            std::vector<int> cpus;
+            std::stringstream in(text);
+            std::string range;
+            while (std::getline(in, range, ','))
+            {
+                if (range.empty() || range == "\n")
+                    continue;
+
+                const size_t dash = range.find('-');
+                const int first = std::stoi(range.substr(0, dash));
+                const int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+                for (int c = first; c <= last; ++c)
+                    cpus.push_back(c);
+            }
+            return cpus;
+        }
+
+        /** @brief Atomic per-node counters, sized once for the host topology (one cache line each). */
+        struct alignas(64) NodeCounters
+        {
+            std::atomic<long long> pathSteps{ 0 };
+            std::atomic<long long> nanoseconds{ 0 };
+        };
+
+        NodeCounters* counters()
+        {
+            static std::unique_ptr<NodeCounters[]> c(new NodeCounters[NumaTopology::host().node_count()]);
+            return c.get();
+        }
+    }
+
+    NumaTopology::NumaTopology()
+    {
+#ifdef __linux__
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        const bool haveMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+        for (int n = 0; n < maxNodes; ++n)
+        {
+            std::ifstream in("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist");
+            if (!in)
+                continue;
+
+            std::string text;
+            std::getline(in, text);
+
+            std::vector<int> cpus;
+            try
+            {
+                for (int c : parse_cpu_list(text))
+                    if (!haveMask || (c < CPU_SETSIZE && CPU_ISSET(c, &allowed)))
+                        cpus.push_back(c);
+            }
+            catch (const std::exception&)
+            {
+                cpus.clear();
+            }
+
+            // Memory-only nodes, or nodes outside the process affinity, run no worker
+            if (!cpus.empty())
+                nodeCpus_.push_back(cpus);
+        }
+#endif
+
+        if (nodeCpus_.empty())
+            nodeCpus_.emplace_back();
+    }
+
+    const NumaTopology& NumaTopology::host()
+    {
+        static const NumaTopology topology;
+        return topology;
+    }
+
+    int NumaTopology::node_count() const
+    {
+        return static_cast<int>(nodeCpus_.size());
+    }
+
+    const std::vector<int>& NumaTopology::cpus(int n) const
+    {
+        return nodeCpus_[n];
+    }
+
+    int NumaTopology::node_of_worker(unsigned int w, unsigned int nWorkers) const
+    {
+        if (nWorkers == 0)
+            return 0;
+        return static_cast<int>(static_cast<unsigned long long>(w) * node_count() / nWorkers);
+    }
+
+    bool pin_to_node(int n)
+    {
+        const NumaTopology& topology = NumaTopology::host();
+        if (topology.node_count() < 2 || n < 0 || n >= topology.node_count())
+            return false;
+
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int c : topology.cpus(n))
+            if (c < CPU_SETSIZE)
+                CPU_SET(c, &set);
+
+        if (sched_setaffinity(0, sizeof(set), &set) != 0)
+            return false;
+
+        threadNode = n;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    int current_node()
+    {
+        return threadNode;
+    }
+
+    void record_node_work(long long pathSteps, double seconds)
+    {
+        NodeCounters& c = counters()[current_node()];
+        c.pathSteps.fetch_add(pathSteps, std::memory_order_relaxed);
+        c.nanoseconds.fetch_add(static_cast<long long>(seconds * 1e9), std::memory_order_relaxed);
+    }
+
+    std::vector<NodeStats> node_stats()
+    {
+        std::vector<NodeStats> stats(NumaTopology::host().node_count());
+        for (size_t n = 0; n < stats.size(); ++n)
+        {
+            stats[n].path_steps = counters()[n].pathSteps.load(std::memory_order_relaxed);
+            stats[n].seconds = counters()[n].nanoseconds.load(std::memory_order_relaxed) * 1e-9;
+        }
+        return stats;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+
+namespace ensiie
+{
+    /**
+     * @brief NUMA nodes of the host and the CPUs of each node usable by the process.
+     *
+     * Read from /sys/devices/system/node on Linux; elsewhere, or if nothing can
+     * be read, the host is one node holding every CPU.
+     */
+    class NumaTopology
+    {
+    public:
+        /** @brief Topology of the host (read once). */
+        static const NumaTopology& host();
+
+        /** @brief Number of nodes with at least one usable CPU (at least 1). */
+        int node_count() const;
+
+        /** @brief Usable CPUs of node n (empty if unknown). */
+        const std::vector<int>& cpus(int n) const;
+
+        /**
+         * @brief Node of worker w of a pool of nWorkers: contiguous ranges of workers
+         * per node, so each node gets its share of the pool.
+         */
+        int node_of_worker(unsigned int w, unsigned int nWorkers) const;
+
+    private:
+        NumaTopology();
+
+        std::vector<std::vector<int>> nodeCpus_;
+    };
+
+    /**
+     * @brief Pins the calling thread to the CPUs of node n and records it as the thread's node.
+     *
+     * Only done on a multi-node Linux host: elsewhere placement is left to the OS.
+     * Memory the thread touches first (its arena chunks, hence its path and
+     * accumulator buffers) is then allocated on its node by the kernel's first-touch
+     * policy.
+     * @return true if the thread was pinned.
+     */
+    bool pin_to_node(int n);
+
+    /** @brief Node the calling thread was pinned to, or 0 if it was not pinned. */
+    int current_node();
+
+    /** @brief Simulation work done on one node. */
+    struct NodeStats
+    {
+        long long path_steps = 0;   ///< Paths x time steps simulated
+        double seconds = 0.0;       ///< Time spent simulating, summed over the node's threads
+    };
+
+    /** @brief Adds simulation work to the node of the calling thread. */
+    void record_node_work(long long pathSteps, double seconds);
+
+    /** @brief Work per node since the start of the process (node_count() entries). */
+    std::vector<NodeStats> node_stats();
+}
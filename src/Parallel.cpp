@@ -0,0 +1,77 @@
+#include "Parallel.h"
+#include "Numa.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ensiie
+{
+    unsigned int worker_count()
+    {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    void parallel_for(int count, const std::function<void(int)>& body)
+    {
+        if (count <= 0)
+            return;
+
+        const unsigned int nThreads = std::min<unsigned int>(worker_count(), static_cast<unsigned int>(count));
+
+        // Single worker: run inline, no thread creation
+        if (nThreads == 1)
+        {
+            for (int i = 0; i < count; ++i)
+                body(i);
+            return;
+        }
+
+        std::atomic<int> next(0);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        auto worker = [&]()
+        {
+            for (int i = next++; i < count; i = next++)
+            {
+                try
+                {
+                    body(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                    next = count; // stop handing out work
+                }
+            }
+        };
+
+        // The calling thread is one of the workers; the others are spread over the
+        // NUMA nodes, so the buffers they touch first are local to them
+        const NumaTopology& topology = NumaTopology::host();
+        std::vector<std::thread> threads;
+        threads.reserve(nThreads - 1);
+        for (unsigned int w = 1; w < nThreads; ++w)
+        {
+            const int node = topology.node_of_worker(w, nThreads);
+            threads.emplace_back([&worker, node]()
+                {
+                    pin_to_node(node);
+                    worker();
+                });
+        }
+
+        worker();
+
+        for (auto& th : threads)
+            th.join();
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
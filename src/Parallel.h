@@ -0,0 +1,22 @@
+#pragma once
+#include <functional>
+
+namespace ensiie
+{
+    /** @brief Number of worker threads used by parallel_for (at least 1). */
+    unsigned int worker_count();
+
+    /**
+     * @brief Runs body(i) for every i in [0, count) on the worker threads.
+     *
+     * Indices are handed out dynamically, one at a time, so count should be a
+     * number of coarse work items (e.g. blocks of paths). Returns once every
+     * item is done; the first exception thrown by body is rethrown.
+     * On a multi-node host, the spawned threads are pinned to the NUMA nodes
+     * (see Numa.h); the calling thread keeps its placement.
+     *
+     * @param count Number of work items.
+     * @param body Work item, must be safe to call concurrently for different i.
+     */
+    void parallel_for(int count, const std::function<void(int)>& body);
+}
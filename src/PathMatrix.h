@@ -0,0 +1,57 @@
+#pragma once
+#include "Arena.h"
+#include <cstddef>
+
+namespace ensiie
+{
+    /**
+     * @brief Contiguous row-major matrix of simulated paths.
+     *
+     * Row i is the i-th path, column k is time step k. A single allocation
+     * keeps the per-path scans streaming through memory; it comes from the
+     * current arena (see Arena.h).
+     *
+     * @tparam T Storage type of the path values (double or float).
+     */
+    template <class T>
+    class PathMatrix
+    {
+    public:
+        /** @brief Resizes to rows x cols (contents are unspecified). */
+        void resize(int rows, int cols)
+        {
+            rows_ = rows;
+            cols_ = cols;
+            data_.resize(static_cast<size_t>(rows) * cols);
+        }
+
+        /** @brief Releases the storage. */
+        void clear()
+        {
+            rows_ = 0;
+            cols_ = 0;
+            data_.clear();
+            data_.shrink_to_fit();
+        }
+
+        /** @brief Pointer to the first value of path i. */
+        T* operator[](int i) { return data_.data() + static_cast<size_t>(i) * cols_; }
+
+        /** @brief Pointer to the first value of path i. */
+        const T* operator[](int i) const { return data_.data() + static_cast<size_t>(i) * cols_; }
+
+        /** @brief Number of paths. */
+        int rows() const { return rows_; }
+
+        /** @brief Number of values per path. */
+        int cols() const { return cols_; }
+
+        /** @brief Returns true if no path is stored. */
+        bool empty() const { return data_.empty(); }
+
+    private:
+        int rows_ = 0;
+        int cols_ = 0;
+        ArenaVector<T> data_;
+    };
+}
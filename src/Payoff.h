@@ -0,0 +1,164 @@
+#pragma once
+#include <cmath>
+
+namespace ensiie
+{
+    /**
+     * @brief Payoff policy for the floating-strike Lookback Call.
+     *
+     * Payoff = S_T - min_{0<=t<=T} S_t, written as sign * (S_T - S_ext)
+     * with S_ext the running minimum.
+     */
+    struct LookbackCallPayoff
+    {
+        /** @brief Option type string understood by Data. */
+        static constexpr const char* name = "call";
+
+        /** @brief Payoff = sign * (S_T - S_ext). */
+        static constexpr double sign = 1.0;
+
+        /** @brief True if a is a strictly better extreme than b (running minimum). */
+        template <class T>
+        static bool beats(T a, T b) { return a < b; }
+    };
+
+    /**
+     * @brief Payoff policy for the floating-strike Lookback Put.
+     *
+     * Payoff = max_{0<=t<=T} S_t - S_T, written as sign * (S_T - S_ext)
+     * with S_ext the running maximum.
+     */
+    struct LookbackPutPayoff
+    {
+        /** @brief Option type string understood by Data. */
+        static constexpr const char* name = "put";
+
+        /** @brief Payoff = sign * (S_T - S_ext). */
+        static constexpr double sign = -1.0;
+
+        /** @brief True if a is a strictly better extreme than b (running maximum). */
+        template <class T>
+        static bool beats(T a, T b) { return a > b; }
+    };
+
+    /**
+     * @brief Per-path kernels instantiated for each payoff policy.
+     *
+     * They work on a raw pointer to n contiguous path values so they are
+     * independent of the path storage, and are fully inlined in the callers.
+     */
+    namespace kernels
+    {
+        /** @brief Value of the path extreme (minimum for the Call, maximum for the Put). */
+        template <class Payoff, class T>
+        inline double extreme_value(const T* path, int n)
+        {
+            // The scan runs in the storage type: no per-value conversion of float paths
+            T ext = path[0];
+            for (int k = 1; k < n; ++k)
+            {
+                const T s = path[k];
+                ext = Payoff::beats(s, ext) ? s : ext;
+            }
+            return ext;
+        }
+
+        /** @brief Index of the first occurrence of the path extreme. */
+        template <class Payoff, class T>
+        inline int extreme_index(const T* path, int n)
+        {
+            int idx = 0;
+            for (int k = 1; k < n; ++k)
+            {
+                if (Payoff::beats(path[k], path[idx]))
+                    idx = k;
+            }
+            return idx;
+        }
+
+        /** @brief Lookback payoff of one path. */
+        template <class Payoff, class T>
+        inline double payoff(const T* path, int n)
+        {
+            return Payoff::sign * (static_cast<double>(path[n - 1]) - extreme_value<Payoff>(path, n));
+        }
+
+        /**
+         * @brief Pathwise derivative of the payoff with respect to sigma.
+         *
+         * For GBM, S_k = S0 exp((r - sigma^2/2) t_k + sigma W_k), hence
+         * dS_k/dsigma = S_k (W_k - sigma t_k) = S_k (log(S_k/S0) - (r + sigma^2/2) t_k) / sigma,
+         * which is the closed form of the step-by-step chain rule. Only the
+         * terminal node and the extreme node are needed.
+         */
+        template <class Payoff, class T>
+        inline double pathwise_vega(const T* path, int n, double S0, double r, double sigma, double dt)
+        {
+            const int ext = extreme_index<Payoff>(path, n);
+            const double drift = r + 0.5 * sigma * sigma;
+
+            auto dS_dsigma = [&](int k)
+            {
+                const double S = static_cast<double>(path[k]);
+                return S * (std::log(S / S0) - drift * k * dt) / sigma;
+            };
+
+            return Payoff::sign * (dS_dsigma(n - 1) - dS_dsigma(ext));
+        }
+
+        /**
+         * @brief Term of step k of the dlog S_k / dsigma recursion (see pathwise_vega_steps()):
+         * A_j (log(S_k/S_{k-1}) - drift_j) / V_j - A_j with j = k - 1.
+         */
+        template <class T>
+        inline double dlog_step(const T* path, int k, const double* drift, const double* diffusion, const double* vol)
+        {
+            const double increment = std::log(static_cast<double>(path[k]) / static_cast<double>(path[k - 1]));
+            const double variance = diffusion[k - 1] * diffusion[k - 1];
+            return vol[k - 1] * (increment - drift[k - 1]) / variance - vol[k - 1];
+        }
+
+        /**
+         * @brief dlog S_k / dsigma at every node k < n, for payoffs that need the
+         * sensitivity of nodes other than the terminal and extreme ones.
+         * @param dlogS Output: n values, dlogS[0] = 0.
+         */
+        template <class T>
+        inline void pathwise_dlog_steps(const T* path, int n,
+            const double* drift, const double* diffusion, const double* vol, double* dlogS)
+        {
+            dlogS[0] = 0.0;
+            for (int k = 1; k < n; ++k)
+                dlogS[k] = dlogS[k - 1] + dlog_step(path, k, drift, diffusion, vol);
+        }
+
+        /**
+         * @brief Pathwise derivative of the payoff for a parallel shift of sigma(t).
+         *
+         * With per-step coefficients drift_j, diffusion_j = sqrt(V_j) and vol_j = A_j
+         * (integrals of r - sigma^2/2, sigma^2 and sigma over step j), a shift of sigma(t)
+         * gives dV_j = 2 A_j, hence
+         * dlog S_k = sum_{j<=k} A_j (log(S_j/S_{j-1}) - drift_j) / V_j - A_j.
+         * Reduces to pathwise_vega() with flat parameters; the increments do not
+         * telescope otherwise, so the whole path is walked.
+         */
+        template <class Payoff, class T>
+        inline double pathwise_vega_steps(const T* path, int n,
+            const double* drift, const double* diffusion, const double* vol)
+        {
+            const int ext = extreme_index<Payoff>(path, n);
+
+            double dlogS = 0.0;
+            double dlogExt = 0.0;
+            for (int k = 1; k < n; ++k)
+            {
+                dlogS += dlog_step(path, k, drift, diffusion, vol);
+
+                if (k == ext)
+                    dlogExt = dlogS;
+            }
+
+            return Payoff::sign * (static_cast<double>(path[n - 1]) * dlogS - static_cast<double>(path[ext]) * dlogExt);
+        }
+    }
+}
@@ -0,0 +1,199 @@
+#include "PayoffSet.h"
+#include "Estimator.h"
+#include "Payoff.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace ensiie
+{
+    namespace
+    {
+        /** @brief Extremes of a path over a window of fixing indices. */
+        struct WindowStats
+        {
+            double min;
+            double max;
+            int argmin;
+            int argmax;
+        };
+
+        /** @brief Payoff value together with its pathwise sensitivities. */
+        struct PathValue
+        {
+            double payoff;
+            double delta;
+            double vega;
+        };
+    }
+
+    PayoffSet::PayoffSet(std::vector<PayoffSpec> specs)
+        : specs_(std::move(specs))
+    {
+        windowOf_.reserve(specs_.size());
+
+        for (const auto& spec : specs_)
+        {
+            if (spec.strike < 0.0)
+                throw std::invalid_argument("Payoff strike must be non-negative.");
+
+            if (spec.window_end < spec.window_start)
+                throw std::invalid_argument("Payoff window end must be non-smaller than its start.");
+
+            // Deduplicate windows so that each one is scanned once per path
+            const std::pair<double, double> w(spec.window_start, spec.window_end);
+            auto it = std::find(windows_.begin(), windows_.end(), w);
+            windowOf_.push_back(static_cast<int>(it - windows_.begin()));
+            if (it == windows_.end())
+                windows_.push_back(w);
+        }
+    }
+
+    std::vector<PayoffResult> PayoffSet::evaluate(const MonteCarlo& mc) const
+    {
+        // Seasoned runs keep path summaries only, not the paths the windows need
+        if (mc.is_seasoned())
+            throw std::invalid_argument("PayoffSet needs a fresh (non-seasoned) run.");
+
+        const auto& grid = mc.get_time_grid();
+        const int N = mc.get_path_count();
+        const int Nt = mc.get_Nt();
+        const double S0 = mc.get_S0();
+        const double r = mc.get_r();
+        const double sigma = mc.get_sigma();
+        const double discount = mc.get_discount();
+        const double drift = r + 0.5 * sigma * sigma;
+
+        // Term structures: dlog S_k / dsigma of every node (kernels::pathwise_dlog_steps)
+        const bool steps = mc.has_term_structure();
+        const ArenaVector<double>& stepDrift = mc.get_drift_table();
+        const ArenaVector<double>& stepDiffusion = mc.get_diffusion_table();
+        const ArenaVector<double>& stepVol = mc.get_vol_table();
+        std::vector<double> dlogS(steps ? Nt + 1 : 0, 0.0);
+
+        // Map each monitoring window onto the fixing indices [first, last]
+        const double tol = 1e-12;
+        std::vector<std::pair<int, int>> bounds;
+        bounds.reserve(windows_.size());
+        for (const auto& w : windows_)
+        {
+            int first = static_cast<int>(std::lower_bound(grid.begin(), grid.end(), w.first - tol) - grid.begin());
+            int last = static_cast<int>(std::upper_bound(grid.begin(), grid.end(), w.second + tol) - grid.begin()) - 1;
+
+            if (first > last)
+                throw std::invalid_argument("Payoff window contains no fixing date.");
+
+            bounds.emplace_back(first, last);
+        }
+
+        const size_t P = specs_.size();
+        // Fixed-shape sums over the blocks of paths (see PathSum and PathMoments)
+        std::vector<PathMoments> payoff;
+        std::vector<PathSum> sumDelta, sumVega;
+        payoff.reserve(P);
+        sumDelta.reserve(P);
+        sumVega.reserve(P);
+        for (size_t p = 0; p < P; ++p)
+        {
+            payoff.emplace_back(N);
+            sumDelta.emplace_back(N);
+            sumVega.emplace_back(N);
+        }
+        std::vector<WindowStats> stats(windows_.size());
+
+        // Likelihood ratios of importance sampling (empty otherwise)
+        const ArenaVector<double>& weights = mc.get_weights();
+
+        // One instantiation of the scan per path storage type
+        mc.visit_paths([&](const auto& paths)
+            {
+                for (int i = 0; i < N; ++i)
+                {
+                    const auto* path = paths[i];
+
+                    // Shared statistics: one scan per distinct window
+                    for (size_t w = 0; w < bounds.size(); ++w)
+                    {
+                        WindowStats s{ path[bounds[w].first], path[bounds[w].first], bounds[w].first, bounds[w].first };
+                        for (int k = bounds[w].first + 1; k <= bounds[w].second; ++k)
+                        {
+                            const double v = path[k];
+                            if (v < s.min) { s.min = v; s.argmin = k; }
+                            if (v > s.max) { s.max = v; s.argmax = k; }
+                        }
+                        stats[w] = s;
+                    }
+
+                    if (steps)
+                        kernels::pathwise_dlog_steps(path, Nt + 1, stepDrift.data(), stepDiffusion.data(),
+                            stepVol.data(), dlogS.data());
+
+                    // Pathwise derivatives of node k: dS_k/dS0 = S_k / S0 and
+                    // dS_k/dsigma = S_k (log(S_k/S0) - (r + sigma^2/2) t_k) / sigma
+                    auto dS_dsigma = [&](int k)
+                    {
+                        if (steps)
+                            return path[k] * dlogS[k];
+                        return path[k] * (std::log(path[k] / S0) - drift * (grid[k] - grid[0])) / sigma;
+                    };
+
+                    const double ST = path[Nt];
+
+                    for (size_t p = 0; p < P; ++p)
+                    {
+                        const PayoffSpec& spec = specs_[p];
+                        const WindowStats& s = stats[windowOf_[p]];
+                        PathValue v{ 0.0, 0.0, 0.0 };
+
+                        switch (spec.kind)
+                        {
+                        case PayoffKind::FloatingCall:
+                            v = { ST - s.min, (ST - s.min) / S0, dS_dsigma(Nt) - dS_dsigma(s.argmin) };
+                            break;
+                        case PayoffKind::FloatingPut:
+                            v = { s.max - ST, (s.max - ST) / S0, dS_dsigma(s.argmax) - dS_dsigma(Nt) };
+                            break;
+                        case PayoffKind::FixedCall:
+                            if (s.max > spec.strike)
+                                v = { s.max - spec.strike, s.max / S0, dS_dsigma(s.argmax) };
+                            break;
+                        case PayoffKind::FixedPut:
+                            if (spec.strike > s.min)
+                                v = { spec.strike - s.min, -s.min / S0, -dS_dsigma(s.argmin) };
+                            break;
+                        case PayoffKind::Spread:
+                            if (s.max - s.min > spec.strike)
+                                v = { s.max - s.min - spec.strike, (s.max - s.min) / S0,
+                                      dS_dsigma(s.argmax) - dS_dsigma(s.argmin) };
+                            break;
+                        }
+
+                        if (!weights.empty())
+                        {
+                            v.payoff *= weights[i];
+                            v.delta *= weights[i];
+                            v.vega *= weights[i];
+                        }
+
+                        payoff[p].add(v.payoff);
+                        sumDelta[p].add(v.delta);
+                        sumVega[p].add(v.vega);
+                    }
+                }
+            });
+
+        std::vector<PayoffResult> results(P);
+        const double n = static_cast<double>(N);
+
+        for (size_t p = 0; p < P; ++p)
+        {
+            const Moments m = payoff[p].value();
+            results[p].price = discount * m.mean();
+            results[p].std_error = discount * m.std_error();
+            results[p].delta = discount * sumDelta[p].value() / n;
+            results[p].vega = discount * sumVega[p].value() / n;
+        }
+
+        return results;
+    }
+}
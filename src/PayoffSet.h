@@ -0,0 +1,84 @@
+#pragma once
+#include "MonteCarlo.h"
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace ensiie
+{
+    /** @brief Lookback payoff variants supported by PayoffSet. */
+    enum class PayoffKind
+    {
+        FloatingCall,   ///< S_T - min S_t
+        FloatingPut,    ///< max S_t - S_T
+        FixedCall,      ///< max(max S_t - K, 0)
+        FixedPut,       ///< max(K - min S_t, 0)
+        Spread          ///< max(max S_t - min S_t - K, 0)
+    };
+
+    /**
+     * @brief Descriptor of one payoff in a PayoffSet.
+     *
+     * The extremes are monitored on the fixing dates of [window_start, window_end]
+     * (clipped to [t, T]); a window narrower than the option life gives a partial
+     * lookback. S_T is always the value at maturity.
+     */
+    struct PayoffSpec
+    {
+        /** @brief Payoff variant. */
+        PayoffKind kind = PayoffKind::FloatingCall;
+
+        /** @brief Strike K (fixed-strike and spread payoffs only). */
+        double strike = 0.0;
+
+        /** @brief Start of the monitoring window. */
+        double window_start = 0.0;
+
+        /** @brief End of the monitoring window. */
+        double window_end = std::numeric_limits<double>::infinity();
+    };
+
+    /** @brief Monte Carlo estimates for one payoff of a PayoffSet. */
+    struct PayoffResult
+    {
+        double price;     ///< Discounted mean payoff
+        double std_error; ///< Standard error of the price
+        double delta;     ///< Pathwise Delta
+        double vega;      ///< Pathwise Vega
+    };
+
+    /**
+     * @brief Prices a strip of lookback payoffs from a single path set.
+     *
+     * For each path the statistics shared by the payoffs (S_T, and min, max,
+     * argmin, argmax of every distinct monitoring window) are extracted once;
+     * every payoff is then evaluated from them, so pricing the whole strip
+     * costs about one scan of the paths.
+     */
+    class PayoffSet
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param specs Payoffs to evaluate (results keep the same order).
+         */
+        explicit PayoffSet(std::vector<PayoffSpec> specs);
+
+        /**
+         * @brief Evaluates every payoff on the paths of mc.
+         * @param mc Simulated paths and market parameters.
+         * @return One result per payoff descriptor.
+         * Throws std::invalid_argument if mc is a seasoned run (no stored paths).
+         */
+        std::vector<PayoffResult> evaluate(const MonteCarlo& mc) const;
+
+    private:
+        std::vector<PayoffSpec> specs_;
+
+        /** @brief Index of the monitoring window of each payoff in a deduplicated window list. */
+        std::vector<int> windowOf_;
+
+        /** @brief Distinct (window_start, window_end) pairs. */
+        std::vector<std::pair<double, double>> windows_;
+    };
+}
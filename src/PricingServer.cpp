@@ -0,0 +1,112 @@
+#include "PricingServer.h"
+#include "Interface.h"
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+namespace ensiie
+{
+    PricingServer::PricingServer(std::ostream& out)
+        : out_(out)
+    {
+    }
+
+    PricingServer::~PricingServer()
+    {
+        wait();
+    }
+
+    void PricingServer::serve(std::istream& in)
+    {
+        std::string line;
+        while (std::getline(in, line))
+            submit(line);
+
+        wait();
+    }
+
+    void PricingServer::submit(const std::string& line)
+    {
+        std::istringstream tokens(line);
+        std::string id;
+        if (!(tokens >> id))
+            return;
+
+        std::vector<std::string> args;
+        for (std::string arg; tokens >> arg;)
+            args.push_back(arg);
+
+        // A newer request for the trade pre-empts the one in flight
+        auto token = std::make_shared<CancellationToken>();
+        {
+            std::lock_guard<std::mutex> lock(activeMutex_);
+            std::shared_ptr<CancellationToken>& current = active_[id];
+            if (current)
+                current->cancel();
+            current = token;
+        }
+
+        // Forget the requests already answered
+        running_.erase(std::remove_if(running_.begin(), running_.end(), [](std::future<void>& f) {
+            return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }), running_.end());
+
+        running_.push_back(std::async(std::launch::async, [this, id, args, token]() {
+            handle(id, args, token);
+        }));
+    }
+
+    void PricingServer::wait()
+    {
+        for (std::future<void>& f : running_)
+            f.wait();
+        running_.clear();
+    }
+
+    void PricingServer::handle(const std::string& id, const std::vector<std::string>& args,
+        const std::shared_ptr<CancellationToken>& token)
+    {
+        std::ostringstream result;
+        std::string response;
+
+        try {
+            // Same argument layout as the command line of the Excel call
+            std::vector<std::string> storage = args;
+            storage.insert(storage.begin(), "pricer");
+            std::vector<char*> argv;
+            for (std::string& arg : storage)
+                argv.push_back(&arg[0]);
+
+            Interface app(static_cast<int>(argv.size()), argv.data(), result);
+            app.set_cancellation(token);
+            app.run();
+
+            // A run stopped by its deadline ends with PARTIAL instead of END
+            response = "BEGIN " + id + "\n" + result.str()
+                + (app.is_partial() ? "PARTIAL " + id + ";" + app.partial_status() : "END " + id) + "\n";
+        }
+        catch (const Cancelled& e) {
+            response = e.deadline_exceeded()
+                ? "ERROR " + id + ";" + e.what() + "\n"
+                : "CANCELLED " + id + "\n";
+        }
+        catch (const std::exception& e) {
+            response = "ERROR " + id + ";" + e.what() + "\n";
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(activeMutex_);
+            auto it = active_.find(id);
+            if (it != active_.end() && it->second == token)
+                active_.erase(it);
+        }
+
+        respond(response);
+    }
+
+    void PricingServer::respond(const std::string& text)
+    {
+        std::lock_guard<std::mutex> lock(outMutex_);
+        out_ << text << std::flush;
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "Cancellation.h"
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ensiie
+{
+    /**
+     * @brief Long-lived pricer serving one request per input line (pricer serve).
+     *
+     * A request line is a trade identifier followed by the Excel arguments and
+     * options: "ID type t T S0 r sigma N dS M seed [--key=value ...]". Requests run
+     * concurrently; a newer request for the same ID cancels the one in flight,
+     * which stops at its next block of paths instead of finishing a stale run.
+     *
+     * Each response is written at once:
+     *   - "BEGIN ID", the output of the run (as printed by Interface), "END ID";
+     *   - "BEGIN ID", the output, "PARTIAL ID;paths;stderr;rows" if the deadline of the
+     *     request stopped it first (see Interface::partial_status());
+     *   - "CANCELLED ID" if a newer request for ID pre-empted it;
+     *   - "ERROR ID;message" if the request failed.
+     */
+    class PricingServer
+    {
+    public:
+        /** @param out Stream receiving the responses. */
+        explicit PricingServer(std::ostream& out);
+
+        /** @brief Waits for the requests in flight. */
+        ~PricingServer();
+
+        PricingServer(const PricingServer&) = delete;
+        PricingServer& operator=(const PricingServer&) = delete;
+
+        /** @brief Serves the request lines of in until end of input, then waits for the requests in flight. */
+        void serve(std::istream& in);
+
+        /** @brief Starts one request line (blank lines are ignored). */
+        void submit(const std::string& line);
+
+        /** @brief Waits for every request in flight. */
+        void wait();
+
+    private:
+        std::ostream& out_;
+        std::mutex outMutex_;
+
+        /** @brief Token of the latest request of each trade. */
+        std::map<std::string, std::shared_ptr<CancellationToken>> active_;
+        std::mutex activeMutex_;
+
+        /** @brief Requests started and not yet waited for. */
+        std::vector<std::future<void>> running_;
+
+        /** @brief Runs one request and writes its response. */
+        void handle(const std::string& id, const std::vector<std::string>& args,
+            const std::shared_ptr<CancellationToken>& token);
+
+        /** @brief Writes a response in one piece. */
+        void respond(const std::string& text);
+    };
+}
@@ -0,0 +1,163 @@
+#include "Richardson.h"
+#include "Payoff.h"
+#include "Estimator.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace ensiie
+{
+    namespace
+    {
+        /** @brief Settings of the fine grid; validates the arguments first. */
+        SimulationSettings fine_settings(double t, double T, int coarseSteps, int refinement,
+            const SimulationSettings& settings)
+        {
+            if (coarseSteps < 1)
+                throw std::invalid_argument("Richardson extrapolation needs at least one coarse step.");
+
+            if (refinement != 2 && refinement != 4)
+                throw std::invalid_argument("Richardson refinement must be 2 or 4.");
+
+            // A contractual schedule is already the target: there is no dt -> 0 limit to reach
+            if (!settings.fixing_dates.empty())
+                throw std::invalid_argument("Richardson extrapolation cannot be combined with a fixing schedule.");
+
+            if (!std::isnan(settings.running_extreme))
+                throw std::invalid_argument("Richardson extrapolation needs a fresh (non-seasoned) trade.");
+
+            SimulationSettings fine = settings;
+            fine.fixing_dates = RichardsonEstimator::nested_schedule(t, T, coarseSteps, refinement);
+            return fine;
+        }
+    }
+
+    RichardsonEstimator::RichardsonEstimator(double t, double T, double S0, double r, double sigma, int N,
+        const std::string& optionType, unsigned long seed, int coarseSteps, int refinement,
+        const SimulationSettings& settings)
+        : coarseSteps_(coarseSteps), refinement_(refinement),
+        fine_(t, T, S0, r, sigma, N, 1.0, 1, optionType, seed, fine_settings(t, T, coarseSteps, refinement, settings))
+    {
+    }
+
+    std::vector<double> RichardsonEstimator::nested_schedule(double t, double T, int coarseSteps, int refinement)
+    {
+        const int steps = coarseSteps * refinement;
+
+        // Interior dates only: MonteCarlo adds t and T, so node k * refinement is coarse node k
+        std::vector<double> dates(steps - 1);
+        for (int j = 1; j < steps; ++j)
+            dates[j - 1] = t + (T - t) * j / steps;
+        return dates;
+    }
+
+    RichardsonResult RichardsonEstimator::run() const
+    {
+        if (fine_.get_option_type() == OptionType::Call)
+            return run_payoff<LookbackCallPayoff>();
+        return run_payoff<LookbackPutPayoff>();
+    }
+
+    template <class Payoff>
+    RichardsonResult RichardsonEstimator::run_payoff() const
+    {
+        const int N = fine_.get_path_count();
+        const int Nt = fine_.get_Nt();
+        const int m = refinement_;
+        const double S0 = fine_.get_S0();
+        const double r = fine_.get_r();
+        const double sigma = fine_.get_sigma();
+        const double drift = r + 0.5 * sigma * sigma;
+        const ArenaVector<double>& grid = fine_.get_time_grid();
+        const ArenaVector<double>& weights = fine_.get_weights();
+
+        // Weight of the fine and coarse values in the extrapolation
+        const double root = std::sqrt(static_cast<double>(m));
+        const double wFine = root / (root - 1.0);
+        const double wCoarse = -1.0 / (root - 1.0);
+
+        // Term structures: dlog S_k / dsigma of every node (kernels::pathwise_dlog_steps)
+        const bool steps = fine_.has_term_structure();
+        const ArenaVector<double>& stepDrift = fine_.get_drift_table();
+        const ArenaVector<double>& stepDiffusion = fine_.get_diffusion_table();
+        const ArenaVector<double>& stepVol = fine_.get_vol_table();
+        std::vector<double> dlogS(steps ? Nt + 1 : 0, 0.0);
+
+        // Fixed-shape sums over the blocks of paths (see PathSum and PathMoments)
+        PathSum sumCoarse(N), sumFine(N), sumVega(N);
+        PathMoments sumExtrap(N), sumBias(N);
+
+        fine_.visit_paths([&](const auto& paths)
+            {
+                for (int i = 0; i < N; ++i)
+                {
+                    const auto* path = paths[i];
+
+                    // Fine extreme over every node, coarse extreme over every m-th node
+                    int extFine = 0;
+                    int extCoarse = 0;
+                    for (int k = 1; k <= Nt; ++k)
+                    {
+                        if (Payoff::beats(path[k], path[extFine]))
+                            extFine = k;
+                        if (k % m == 0 && Payoff::beats(path[k], path[extCoarse]))
+                            extCoarse = k;
+                    }
+
+                    if (steps)
+                        kernels::pathwise_dlog_steps(path, Nt + 1, stepDrift.data(), stepDiffusion.data(),
+                            stepVol.data(), dlogS.data());
+
+                    // Pathwise dS_k/dsigma, as in kernels::pathwise_vega
+                    auto dS_dsigma = [&](int k)
+                    {
+                        const double S = static_cast<double>(path[k]);
+                        if (steps)
+                            return S * dlogS[k];
+                        return S * (std::log(S / S0) - drift * (grid[k] - grid[0])) / sigma;
+                    };
+
+                    const double w = weights.empty() ? 1.0 : weights[i];
+                    const double ST = static_cast<double>(path[Nt]);
+
+                    const double fine = w * Payoff::sign * (ST - static_cast<double>(path[extFine]));
+                    const double coarse = w * Payoff::sign * (ST - static_cast<double>(path[extCoarse]));
+                    const double extrap = wFine * fine + wCoarse * coarse;
+                    const double bias = fine - extrap;
+
+                    const double dSdT = dS_dsigma(Nt);
+                    const double vegaFine = w * Payoff::sign * (dSdT - dS_dsigma(extFine));
+                    const double vegaCoarse = w * Payoff::sign * (dSdT - dS_dsigma(extCoarse));
+
+                    sumFine.add(fine);
+                    sumCoarse.add(coarse);
+                    sumExtrap.add(extrap);
+                    sumBias.add(bias);
+                    sumVega.add(wFine * vegaFine + wCoarse * vegaCoarse);
+                }
+            });
+
+        const double n = static_cast<double>(N);
+        const double discount = fine_.get_discount();
+
+        RichardsonResult res;
+        res.coarse_steps = coarseSteps_;
+        res.fine_steps = Nt;
+
+        const Moments extrap = sumExtrap.value();
+        res.price = discount * extrap.mean();
+        res.std_error = discount * extrap.std_error();
+
+        // The payoffs of both grids are homogeneous in S0: pathwise Delta = price / S0
+        res.delta = res.price / S0;
+        res.vega = discount * sumVega.value() / n;
+
+        res.price_coarse = discount * sumCoarse.value() / n;
+        res.price_fine = discount * sumFine.value() / n;
+
+        const Moments bias = sumBias.value();
+        res.bias = discount * bias.mean();
+        res.bias_std_error = discount * bias.std_error();
+        return res;
+    }
+}
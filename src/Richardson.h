@@ -0,0 +1,71 @@
+#pragma once
+#include "MonteCarlo.h"
+#include <string>
+#include <vector>
+
+namespace ensiie
+{
+    /** @brief Estimates of a Richardson-extrapolated run. */
+    struct RichardsonResult
+    {
+        int coarse_steps;        ///< Steps of the coarse grid over [t, T]
+        int fine_steps;          ///< Steps of the fine grid (coarse_steps x refinement)
+        double price;            ///< Extrapolated price (dt -> 0)
+        double delta;            ///< Extrapolated pathwise Delta
+        double vega;             ///< Extrapolated pathwise Vega
+        double price_coarse;     ///< Price on the coarse grid
+        double price_fine;       ///< Price on the fine grid
+        double bias;             ///< Estimated discretization bias of the fine price (fine - extrapolated)
+        double std_error;        ///< Standard error of the extrapolated price
+        double bias_std_error;   ///< Standard error of the bias estimate
+    };
+
+    /**
+     * @brief Richardson extrapolation in the time step of the discrete-monitoring bias.
+     *
+     * The bias of a discretely monitored extreme behaves like c sqrt(dt), so from
+     * prices P(h) and P(h/m) on two grids,
+     * P(0) ~ (sqrt(m) P(h/m) - P(h)) / (sqrt(m) - 1).
+     * The paths are simulated once on the fine grid; the coarse grid is every m-th
+     * node of the same paths (exact GBM steps), so both prices share their Brownian
+     * increments and the extrapolation is applied path by path.
+     */
+    class RichardsonEstimator
+    {
+    public:
+        /**
+         * @brief Constructor: simulates the fine-grid paths.
+         *
+         * @param t Initial time.
+         * @param T Maturity time.
+         * @param S0 Spot price.
+         * @param r Risk-free interest rate.
+         * @param sigma Volatility.
+         * @param N Number of Monte Carlo Simulations.
+         * @param optionType Option type ("call" or "put").
+         * @param seed Random number generator seed.
+         * @param coarseSteps Number of coarse steps over [t, T].
+         * @param refinement Ratio m of the coarse to the fine step (2 or 4).
+         * @param settings Simulation settings; a fixing schedule or a running
+         * extreme is rejected (std::invalid_argument).
+         */
+        RichardsonEstimator(double t, double T, double S0, double r, double sigma, int N,
+            const std::string& optionType, unsigned long seed, int coarseSteps, int refinement,
+            const SimulationSettings& settings = SimulationSettings());
+
+        /** @brief Coarse and fine prices, extrapolated price and Greeks, and bias estimate. */
+        RichardsonResult run() const;
+
+        /** @brief Fixing dates of a uniform grid of coarseSteps x refinement steps over (t, T). */
+        static std::vector<double> nested_schedule(double t, double T, int coarseSteps, int refinement);
+
+    private:
+        int coarseSteps_;
+        int refinement_;
+        MonteCarlo fine_;
+
+        /** @brief run() for one payoff policy. */
+        template <class Payoff>
+        RichardsonResult run_payoff() const;
+    };
+}
@@ -0,0 +1,163 @@
+#include "ScenarioEngine.h"
+#include "Estimator.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace ensiie
+{
+    ScenarioEngine::ScenarioEngine(OptionType type, double t, double T, double S0, double r, double sigma,
+        int N, unsigned long seed, const SimulationSettings& settings)
+        : optionType_(type), t_(t), T_(T), S0_(S0), r_(r), sigma_(sigma), dt_(1.0 / 252.0),
+        N_(N), Nt_(MonteCarlo::step_count(t, T, {})), seed_(seed), settings_(settings)
+    {
+        // Same checks and messages as the base run: Data, then MonteCarlo
+        const Data inputs(t, T, S0, r, sigma, N, 1.0, 1, type == OptionType::Call ? "call" : "put", seed);
+        MonteCarlo::check_grid_and_volatility(Nt_, sigma_, true);
+        MonteCarlo::check_sampling(N_, settings_);
+
+        // Likelihood ratios depend on the scenario maturity: not supported
+        if (settings_.drift_shift != 0.0)
+            throw std::invalid_argument("ScenarioEngine does not support importance sampling.");
+
+        // Scenarios override flat r and sigma on the daily grid of a fresh trade
+        if (!settings_.rate_curve.empty() || !settings_.vol_curve.empty() || !settings_.fixing_dates.empty()
+            || !std::isnan(settings_.running_extreme))
+            throw std::invalid_argument(
+                "ScenarioEngine does not support term structures, fixing schedules or seasoned trades.");
+    }
+
+    ScenarioResult ScenarioEngine::run(const ScenarioGrid& grid) const
+    {
+        const std::vector<double> S0s = grid.S0.empty() ? std::vector<double>{ S0_ } : grid.S0;
+        const std::vector<double> sigmas = grid.sigma.empty() ? std::vector<double>{ sigma_ } : grid.sigma;
+        const std::vector<double> rs = grid.r.empty() ? std::vector<double>{ r_ } : grid.r;
+        const std::vector<double> ts = grid.t.empty() ? std::vector<double>{ t_ } : grid.t;
+
+        for (double s : S0s)
+            if (s < 0.0)
+                throw std::invalid_argument("Scenario S0 must be non-negative.");
+
+        // A scenario is a run of its own: same grid and volatility checks
+        for (double s : sigmas)
+            MonteCarlo::check_grid_and_volatility(Nt_, s, true);
+
+        // Number of steps of each t scenario: a prefix of the base normals
+        const size_t nT = ts.size();
+        std::vector<int> steps(nT);
+        for (size_t j = 0; j < nT; ++j)
+        {
+            if (ts[j] < t_)
+                throw std::invalid_argument("Scenario t must be non-smaller than the base t.");
+
+            steps[j] = std::min(Nt_, MonteCarlo::step_count(ts[j], T_, {}));
+            MonteCarlo::check_grid_and_volatility(steps[j], sigma_, true);
+        }
+
+        // Visit the checkpoints in increasing number of steps
+        std::vector<size_t> order(nT);
+        for (size_t j = 0; j < nT; ++j)
+            order[j] = j;
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return steps[a] < steps[b]; });
+
+        const size_t nSigma = sigmas.size();
+        const size_t nR = rs.size();
+        const size_t nScenarios = nSigma * nR;
+        const int nBlocks = MonteCarlo::block_count(N_);
+        const bool isCall = (optionType_ == OptionType::Call);
+        const double sqrt_dt = std::sqrt(dt_);
+
+        // Per (sigma, r) and block: moments of the unit-spot payoff for every t
+        std::vector<Moments> partial(nScenarios * nBlocks * nT);
+
+        parallel_for(nBlocks, [&](int block)
+            {
+                if (settings_.cancellation)
+                    settings_.cancellation->throw_if_stop_requested();
+
+                in_thread_arena([&]()
+                    {
+                        // Normals of this block only, step-major, walked by every (sigma, r)
+                        const int count = std::min(MonteCarlo::block_size, N_ - block * MonteCarlo::block_size);
+                        ArenaVector<double> Z(static_cast<size_t>(Nt_) * count);
+                        MonteCarlo::block_normals(seed_, N_, Nt_, settings_, block, Z.data(), count);
+
+                        // Log-space walk of every path of the block, and its payoffs for every t
+                        ArenaVector<double> x(count), xmin(count), xmax(count);
+                        ArenaVector<double> payoffs(nT * count);
+
+                        for (size_t scenario = 0; scenario < nScenarios; ++scenario)
+                        {
+                            const double sigma = sigmas[scenario / nR];
+                            const double r = rs[scenario % nR];
+
+                            // x_k = sum_j (r - sigma^2/2) dt + sigma sqrt(dt) Z_j
+                            const double muTerm = (r - 0.5 * sigma * sigma) * dt_;
+                            const double sigmaTerm = sigma * sqrt_dt;
+
+                            std::fill(x.begin(), x.end(), 0.0);
+                            std::fill(xmin.begin(), xmin.end(), 0.0);
+                            std::fill(xmax.begin(), xmax.end(), 0.0);
+                            int k = 0;
+
+                            for (size_t j : order)
+                            {
+                                for (; k < steps[j]; ++k)
+                                {
+                                    const double* z = &Z[static_cast<size_t>(k) * count];
+                                    for (int i = 0; i < count; ++i)
+                                    {
+                                        x[i] += muTerm + sigmaTerm * z[i];
+                                        xmin[i] = std::min(xmin[i], x[i]);
+                                        xmax[i] = std::max(xmax[i], x[i]);
+                                    }
+                                }
+
+                                // The extreme of S is the exponential of the extreme of log S
+                                double* p = &payoffs[j * count];
+                                for (int i = 0; i < count; ++i)
+                                    p[i] = isCall ? std::exp(x[i]) - std::exp(xmin[i])
+                                                  : std::exp(xmax[i]) - std::exp(x[i]);
+                            }
+
+                            Moments* out = &partial[(scenario * nBlocks + block) * nT];
+                            for (size_t j = 0; j < nT; ++j)
+                                out[j] = sample_moments(&payoffs[j * count], count);
+                        }
+                    });
+            });
+
+        ScenarioResult result;
+        result.nS0 = S0s.size();
+        result.nSigma = nSigma;
+        result.nR = nR;
+        result.nT = nT;
+        result.price.resize(result.nS0 * nSigma * nR * nT);
+        result.std_error.resize(result.price.size());
+
+        for (size_t iSigma = 0; iSigma < nSigma; ++iSigma)
+        {
+            for (size_t iR = 0; iR < nR; ++iR)
+            {
+                for (size_t iT = 0; iT < nT; ++iT)
+                {
+                    // Merge the blocks by a fixed pairwise tree
+                    const size_t firstItem = (iSigma * nR + iR) * nBlocks;
+                    const Moments payoff = fold_moments(nBlocks,
+                        [&](int b) { return partial[(firstItem + b) * nT + iT]; });
+                    const double discount = std::exp(-rs[iR] * (T_ - ts[iT]));
+
+                    for (size_t iS0 = 0; iS0 < result.nS0; ++iS0)
+                    {
+                        const size_t idx = result.index(iS0, iSigma, iR, iT);
+                        result.price[idx] = S0s[iS0] * discount * payoff.mean();
+                        result.std_error[idx] = S0s[iS0] * discount * payoff.std_error();
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+}
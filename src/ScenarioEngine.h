@@ -0,0 +1,97 @@
+#pragma once
+#include "MonteCarlo.h"
+#include <vector>
+
+namespace ensiie
+{
+    /**
+     * @brief Axes of a scenario grid.
+     *
+     * An empty axis stands for the single base value of the engine.
+     */
+    struct ScenarioGrid
+    {
+        std::vector<double> S0;      ///< Spot prices
+        std::vector<double> sigma;   ///< Volatilities
+        std::vector<double> r;       ///< Risk-free rates
+        std::vector<double> t;       ///< Valuation times (maturity is kept)
+    };
+
+    /**
+     * @brief Dense result tensor of a scenario run.
+     *
+     * Values are stored row-major with shape [S0][sigma][r][t].
+     */
+    struct ScenarioResult
+    {
+        size_t nS0 = 0;
+        size_t nSigma = 0;
+        size_t nR = 0;
+        size_t nT = 0;
+
+        std::vector<double> price;      ///< Discounted Monte Carlo price
+        std::vector<double> std_error;  ///< Standard error of the price
+
+        /** @brief Flat index of scenario (iS0, iSigma, iR, iT). */
+        size_t index(size_t iS0, size_t iSigma, size_t iR, size_t iT) const
+        {
+            return ((iS0 * nSigma + iSigma) * nR + iR) * nT + iT;
+        }
+    };
+
+    /**
+     * @brief Prices a lookback over a whole (S0, sigma, r, t) grid with common random numbers.
+     *
+     * The standard normals of the base run (same seed, N, time grid and sampling
+     * scheme) are shared by every scenario, so bumps are not polluted by
+     * simulation noise. The payoff is homogeneous in S0, so the spot axis is a
+     * scaling of the unit-spot price; all t scenarios are read from one walk per
+     * path (they use a prefix of the same normals).
+     *
+     * The base run is never simulated: work is split by block of
+     * MonteCarlo::block_size paths, each work item draws the normals of its block
+     * (MonteCarlo::block_normals) and walks them for every (sigma, r), so memory
+     * is one block of block_size x Nt normals per worker (about 2 MB for a daily
+     * one-year grid) instead of the N x Nt normals and the path matrix.
+     */
+    class ScenarioEngine
+    {
+    public:
+        /**
+         * @brief Constructor: validates the base run as a MonteCarlo of the same inputs would.
+         *
+         * @param type Option type.
+         * @param t Initial time.
+         * @param T Maturity time.
+         * @param S0 Spot price.
+         * @param r Risk-free interest rate.
+         * @param sigma Volatility.
+         * @param N Number of Monte Carlo Simulations.
+         * @param seed Seed of the common normals.
+         * @param settings Sampling scheme of the common normals (a normal store holds the
+         * same stream, the precision and the shard and block fields are ignored) and
+         * cancellation of the run.
+         * Throws std::invalid_argument for inputs a Call or Put run rejects, and for
+         * importance sampling, term structures, a fixing schedule or a running extreme.
+         */
+        ScenarioEngine(OptionType type, double t, double T, double S0, double r, double sigma,
+            int N, unsigned long seed, const SimulationSettings& settings = SimulationSettings());
+
+        /**
+         * @brief Evaluates every scenario of the grid.
+         *
+         * Throws std::invalid_argument, with the message of a single run, for a
+         * negative S0, a sigma or t the base run would reject, or a t before the base t.
+         * @param grid Scenario axes (empty axis = base value).
+         * @return Dense price and standard error tensors.
+         */
+        ScenarioResult run(const ScenarioGrid& grid) const;
+
+    private:
+        OptionType optionType_;
+        double t_, T_, S0_, r_, sigma_, dt_;
+        int N_, Nt_;
+        unsigned long seed_;
+        SimulationSettings settings_;
+    };
+}
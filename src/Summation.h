@@ -0,0 +1,137 @@
+#pragma once
+
+namespace ensiie
+{
+    /**
+     * @brief Kahan compensated sum.
+     *
+     * Keeps the rounding error of each addition in a compensation term so that
+     * long estimator sums (large N, single-precision inputs) lose no digits.
+     */
+    class KahanSum
+    {
+    public:
+        /** @brief Adds x to the sum. */
+        void add(double x)
+        {
+            const double y = x - c_;
+            const double t = sum_ + y;
+            c_ = (t - sum_) - y;
+            sum_ = t;
+        }
+
+        /** @brief Returns the compensated sum. */
+        double value() const { return sum_; }
+
+    private:
+        double sum_ = 0.0;
+        double c_ = 0.0;
+    };
+
+    /**
+     * @brief Number of interleaved partial sums of a block: part of the reduction's
+     * shape, fixed whatever the SIMD width the compiler targets.
+     */
+    constexpr int summation_lanes = 8;
+
+    /**
+     * @brief Fixed-shape pairwise reduction of leaf(first), ..., leaf(first + n - 1).
+     *
+     * The range is split at the largest power of two below n, recursively, so the
+     * tree (hence the rounding) only depends on n: the same leaves give the same
+     * bits whatever produced them (thread count, chunking, shards).
+     * @return combine() of the two halves; T() for an empty range.
+     */
+    template <class T, class F, class Op>
+    T pairwise_reduce(int first, int n, F&& leaf, Op&& combine)
+    {
+        if (n <= 0)
+            return T();
+        if (n == 1)
+            return leaf(first);
+
+        int half = 1;
+        while (2 * half < n)
+            half *= 2;
+
+        return combine(pairwise_reduce<T>(first, half, leaf, combine),
+            pairwise_reduce<T>(first + half, n - half, leaf, combine));
+    }
+
+    /**
+     * @brief Fixed-shape pairwise sum of total(0), ..., total(n - 1) (pairwise_reduce()).
+     *
+     * The error grows like log2(n) instead of n for a sequential sum.
+     */
+    template <class F>
+    double pairwise_sum(int first, int n, F&& total)
+    {
+        return pairwise_reduce<double>(first, n, total, [](double a, double b) { return a + b; });
+    }
+
+    /**
+     * @brief Compensated sum of one block of values, added in path order.
+     *
+     * Value i goes to lane i % summation_lanes, each lane a Kahan sum; the
+     * compensated lane totals are then added by pairwise_sum(). The lanes are
+     * independent, so the loop of block_sum() vectorizes, and this streaming form
+     * (for values computed on the fly) gives bit-identical totals.
+     */
+    class BlockAccumulator
+    {
+    public:
+        /** @brief Adds the next value of the block. */
+        void add(double x)
+        {
+            const int j = next_;
+            const double y = x - c_[j];
+            const double t = sum_[j] + y;
+            c_[j] = (t - sum_[j]) - y;
+            sum_[j] = t;
+            next_ = (j + 1 == summation_lanes) ? 0 : j + 1;
+        }
+
+        /** @brief Adds values[0..count) in order (vectorizable: lane j takes values j, j + 8, ...). */
+        void add(const double* values, int count)
+        {
+            int i = 0;
+
+            // Whole rows of lanes, once the next value is back on lane 0
+            if (next_ == 0)
+            {
+                for (; i + summation_lanes <= count; i += summation_lanes)
+                {
+                    for (int j = 0; j < summation_lanes; ++j)
+                    {
+                        const double y = values[i + j] - c_[j];
+                        const double t = sum_[j] + y;
+                        c_[j] = (t - sum_[j]) - y;
+                        sum_[j] = t;
+                    }
+                }
+            }
+
+            for (; i < count; ++i)
+                add(values[i]);
+        }
+
+        /** @brief Returns the total of the values added so far. */
+        double value() const
+        {
+            return pairwise_sum(0, summation_lanes, [this](int j) { return sum_[j] - c_[j]; });
+        }
+
+    private:
+        double sum_[summation_lanes] = {};
+        double c_[summation_lanes] = {};
+        int next_ = 0;
+    };
+
+    /** @brief Total of values[0..count) by BlockAccumulator. */
+    inline double block_sum(const double* values, int count)
+    {
+        BlockAccumulator sum;
+        sum.add(values, count);
+        return sum.value();
+    }
+}
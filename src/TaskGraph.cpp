@@ -0,0 +1,115 @@
+#include "TaskGraph.h"
+#include <stdexcept>
+
+namespace ensiie
+{
+    TaskGraph::TaskId TaskGraph::add(std::function<void()> fn, const std::vector<TaskId>& deps)
+    {
+        if (pool_)
+            throw std::logic_error("Tasks must be added before the graph is run.");
+
+        const TaskId id = nodes_.size();
+        nodes_.emplace_back();
+        nodes_[id].fn = std::move(fn);
+        nodes_[id].pending = deps.size();
+
+        for (TaskId dep : deps)
+        {
+            if (dep >= id)
+                throw std::invalid_argument("Task dependency must be added before its dependent.");
+            nodes_[dep].dependents.push_back(id);
+        }
+
+        return id;
+    }
+
+    void TaskGraph::run(ThreadPool& pool)
+    {
+        std::vector<TaskId> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pool_ = &pool;
+            for (TaskId id = 0; id < nodes_.size(); ++id)
+                if (nodes_[id].pending == 0)
+                    ready.push_back(id);
+        }
+
+        for (TaskId id : ready)
+            launch(id);
+    }
+
+    void TaskGraph::launch(TaskId id)
+    {
+        pool_->submit([this, id]()
+            {
+                std::exception_ptr error;
+                try
+                {
+                    nodes_[id].fn();
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                complete(id, error);
+            });
+    }
+
+    void TaskGraph::complete(TaskId id, std::exception_ptr error)
+    {
+        std::vector<TaskId> ready;
+        std::vector<TaskId> failed;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            // Iterative propagation: a failed task fails its dependents without running them
+            std::vector<std::pair<TaskId, std::exception_ptr>> stack{ { id, error } };
+            while (!stack.empty())
+            {
+                auto [current, err] = stack.back();
+                stack.pop_back();
+
+                Node& node = nodes_[current];
+                node.done = true;
+                node.error = err;
+
+                for (TaskId dep : node.dependents)
+                {
+                    Node& d = nodes_[dep];
+                    if (d.done)
+                        continue;
+
+                    if (err)
+                        stack.emplace_back(dep, err);
+                    else if (--d.pending == 0)
+                        ready.push_back(dep);
+                }
+            }
+        }
+        cv_.notify_all();
+
+        for (TaskId r : ready)
+            launch(r);
+    }
+
+    void TaskGraph::wait(TaskId id)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&]() { return nodes_[id].done; });
+
+        if (nodes_[id].error)
+            std::rethrow_exception(nodes_[id].error);
+    }
+
+    void TaskGraph::wait_all()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&]()
+            {
+                for (const Node& node : nodes_)
+                    if (!node.done)
+                        return false;
+                return true;
+            });
+    }
+}
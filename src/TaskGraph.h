@@ -0,0 +1,65 @@
+#pragma once
+#include "ThreadPool.h"
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ensiie
+{
+    /**
+     * @brief Dependency graph of tasks executed on a ThreadPool.
+     *
+     * A task is submitted to the pool as soon as all its dependencies are done,
+     * so independent tasks run concurrently. Callers block on individual tasks
+     * with wait(), which lets results be consumed (e.g. printed) in a fixed
+     * order as soon as each one is ready. If a task throws, the exception is
+     * stored and propagated to its dependents, which are not run.
+     */
+    class TaskGraph
+    {
+    public:
+        /** @brief Identifier of a task in the graph. */
+        using TaskId = size_t;
+
+        /**
+         * @brief Adds a task. Must be called before run().
+         * @param fn Work of the task.
+         * @param deps Tasks that must complete first.
+         * @return Identifier of the new task.
+         */
+        TaskId add(std::function<void()> fn, const std::vector<TaskId>& deps = {});
+
+        /** @brief Starts every task whose dependencies are satisfied on pool. */
+        void run(ThreadPool& pool);
+
+        /** @brief Blocks until task id is done; rethrows its exception, if any. */
+        void wait(TaskId id);
+
+        /** @brief Blocks until every task is done (exceptions are not rethrown). */
+        void wait_all();
+
+    private:
+        struct Node
+        {
+            std::function<void()> fn;
+            std::vector<TaskId> dependents;
+            size_t pending = 0;          ///< Dependencies not yet done
+            bool done = false;
+            std::exception_ptr error;
+        };
+
+        std::vector<Node> nodes_;
+        ThreadPool* pool_ = nullptr;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+
+        /** @brief Submits task id to the pool. */
+        void launch(TaskId id);
+
+        /** @brief Marks id done and launches the dependents that became ready. */
+        void complete(TaskId id, std::exception_ptr error);
+    };
+}
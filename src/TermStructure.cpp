@@ -0,0 +1,103 @@
+#include "TermStructure.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace ensiie
+{
+    TermStructure::TermStructure(std::vector<double> times, std::vector<double> values)
+        : times_(std::move(times)), values_(std::move(values))
+    {
+        if (times_.size() != values_.size())
+            throw std::invalid_argument("Term structure needs one value per pillar.");
+
+        for (size_t j = 0; j < times_.size(); ++j)
+        {
+            if (!std::isfinite(times_[j]) || !std::isfinite(values_[j]))
+                throw std::invalid_argument("Term structure pillars and values must be finite.");
+
+            if (j > 0 && times_[j] <= times_[j - 1])
+                throw std::invalid_argument("Term structure pillars must be strictly increasing.");
+        }
+    }
+
+    TermStructure TermStructure::parse(const std::string& text)
+    {
+        std::vector<double> times, values;
+
+        size_t begin = 0;
+        while (begin < text.size())
+        {
+            size_t end = text.find(',', begin);
+            if (end == std::string::npos)
+                end = text.size();
+
+            const std::string pillar = text.substr(begin, end - begin);
+            const size_t colon = pillar.find(':');
+            if (colon == std::string::npos)
+                throw std::invalid_argument("Term structure pillars must be given as T:value.");
+
+            times.push_back(std::stod(pillar.substr(0, colon)));
+            values.push_back(std::stod(pillar.substr(colon + 1)));
+            begin = end + 1;
+        }
+
+        if (times.empty())
+            throw std::invalid_argument("Term structure needs at least one pillar.");
+
+        return TermStructure(std::move(times), std::move(values));
+    }
+
+    double TermStructure::value(double s) const
+    {
+        // First pillar not before s; past the last pillar the last value holds
+        const size_t j = std::lower_bound(times_.begin(), times_.end(), s) - times_.begin();
+        return values_[std::min(j, values_.size() - 1)];
+    }
+
+    template <class F>
+    double TermStructure::integrate(double a, double b, F&& f) const
+    {
+        double sum = 0.0;
+        double left = a;
+
+        // Segment j is (T_{j-1}, T_j]; the last one extends to +infinity
+        for (size_t j = 0; j < times_.size() && left < b; ++j)
+        {
+            const double right = (j + 1 == times_.size()) ? b : std::min(b, times_[j]);
+            if (right > left)
+            {
+                sum += f(values_[j]) * (right - left);
+                left = right;
+            }
+        }
+
+        return sum;
+    }
+
+    double TermStructure::integral(double a, double b) const
+    {
+        return integrate(a, b, [](double v) { return v; });
+    }
+
+    double TermStructure::integral_sq(double a, double b) const
+    {
+        return integrate(a, b, [](double v) { return v * v; });
+    }
+
+    TermStructure TermStructure::shifted(double h) const
+    {
+        TermStructure bumped(*this);
+        for (double& v : bumped.values_)
+            v += h;
+        return bumped;
+    }
+
+    double discount_factor(double r, const TermStructure& curve, double t, double T)
+    {
+        if (curve.empty())
+            return std::exp(-r * (T - t));
+        return std::exp(-curve.integral(t, T));
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace ensiie
+{
+    /**
+     * @brief Piecewise-constant term structure of a market parameter (rate or volatility).
+     *
+     * Pillars T_1 < ... < T_m carry values v_1, ..., v_m: the parameter equals v_j
+     * on (T_{j-1}, T_j] (v_1 before T_1) and stays at v_m after the last pillar.
+     * An empty term structure means "use the flat parameter".
+     */
+    class TermStructure
+    {
+    public:
+        /** @brief Empty (flat) term structure. */
+        TermStructure() = default;
+
+        /**
+         * @brief Constructor.
+         * @param times Pillar times, strictly increasing.
+         * @param values Parameter value up to each pillar (same size as times).
+         */
+        TermStructure(std::vector<double> times, std::vector<double> values);
+
+        /**
+         * @brief Parses "T1:v1,T2:v2,...", the format of the command line options.
+         */
+        static TermStructure parse(const std::string& text);
+
+        /** @brief Returns true if no pillar is set. */
+        bool empty() const { return times_.empty(); }
+
+        /** @brief Value at time s. */
+        double value(double s) const;
+
+        /** @brief Integral of the parameter over [a, b]. */
+        double integral(double a, double b) const;
+
+        /** @brief Integral of the squared parameter over [a, b]. */
+        double integral_sq(double a, double b) const;
+
+        /** @brief Same term structure with every value shifted by h (parallel bump). */
+        TermStructure shifted(double h) const;
+
+        /** @brief Returns the pillar times. */
+        const std::vector<double>& get_times() const { return times_; }
+
+        /** @brief Returns the pillar values. */
+        const std::vector<double>& get_values() const { return values_; }
+
+        bool operator==(const TermStructure& other) const
+        {
+            return times_ == other.times_ && values_ == other.values_;
+        }
+
+        bool operator!=(const TermStructure& other) const { return !(*this == other); }
+
+    private:
+        std::vector<double> times_;
+        std::vector<double> values_;
+
+        /** @brief Integral of f(value) over [a, b], segment by segment. */
+        template <class F>
+        double integrate(double a, double b, F&& f) const;
+    };
+
+    /**
+     * @brief Discount factor from t to T: exp(-r (T - t)) with a flat rate,
+     * exp(-integral of the curve) otherwise.
+     */
+    double discount_factor(double r, const TermStructure& curve, double t, double T);
+}
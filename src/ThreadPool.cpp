@@ -0,0 +1,89 @@
+#include "ThreadPool.h"
+#include "Numa.h"
+#include <algorithm>
+
+namespace ensiie
+{
+    ThreadPool::ThreadPool(unsigned int nThreads)
+    {
+        nThreads = std::max(1u, nThreads);
+        workers_.reserve(nThreads);
+        // Workers are spread over the NUMA nodes, so each one's arena is local to it
+        const NumaTopology& topology = NumaTopology::host();
+        for (unsigned int i = 0; i < nThreads; ++i)
+        {
+            const int node = topology.node_of_worker(i, nThreads);
+            workers_.emplace_back([this, node]()
+                {
+                    pin_to_node(node);
+                    work();
+                });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    void ThreadPool::submit(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+        }
+        cv_.notify_one();
+    }
+
+    unsigned int ThreadPool::size() const
+    {
+        return static_cast<unsigned int>(workers_.size());
+    }
+
+    void ThreadPool::work()
+    {
+        for (;;)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+
+                if (jobs_.empty())
+                    return; // stopping and drained
+
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            job();
+        }
+    }
+
+    Semaphore::Semaphore(int count)
+        : count_(std::max(1, count))
+    {
+    }
+
+    void Semaphore::acquire()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return count_ > 0; });
+        --count_;
+    }
+
+    void Semaphore::release()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++count_;
+        }
+        cv_.notify_one();
+    }
+}
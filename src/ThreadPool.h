@@ -0,0 +1,100 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ensiie
+{
+    /**
+     * @brief Fixed-size pool of worker threads executing queued jobs in FIFO order.
+     *
+     * The destructor waits for every queued job to finish before joining.
+     * On a multi-node host, the workers are pinned to the NUMA nodes in
+     * contiguous ranges (see Numa.h).
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param nThreads Number of worker threads (at least 1).
+         */
+        explicit ThreadPool(unsigned int nThreads);
+
+        /** @brief Drains the queue and joins the workers. */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /** @brief Queues a job. Jobs must not throw (wrap them if they can). */
+        void submit(std::function<void()> job);
+
+        /** @brief Returns the number of worker threads. */
+        unsigned int size() const;
+
+    private:
+        std::vector<std::thread> workers_;
+        std::deque<std::function<void()>> jobs_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool stopping_ = false;
+
+        /** @brief Worker loop: pops and runs jobs until stopping and the queue is empty. */
+        void work();
+    };
+
+    /**
+     * @brief Counting semaphore bounding how many jobs hold a resource at once
+     * (e.g. a path matrix), whatever the number of workers.
+     *
+     * Holders must not wait for other jobs, so waiters always make progress.
+     */
+    class Semaphore
+    {
+    public:
+        /** @param count Number of units (at least 1). */
+        explicit Semaphore(int count);
+
+        Semaphore(const Semaphore&) = delete;
+        Semaphore& operator=(const Semaphore&) = delete;
+
+        /** @brief Waits for a free unit and takes it. */
+        void acquire();
+
+        /** @brief Gives a unit back. */
+        void release();
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        int count_;
+    };
+
+    /** @brief Holds one unit of a Semaphore for its lifetime (no-op on a null semaphore). */
+    class SemaphoreGuard
+    {
+    public:
+        explicit SemaphoreGuard(Semaphore* semaphore)
+            : semaphore_(semaphore)
+        {
+            if (semaphore_)
+                semaphore_->acquire();
+        }
+
+        ~SemaphoreGuard()
+        {
+            if (semaphore_)
+                semaphore_->release();
+        }
+
+        SemaphoreGuard(const SemaphoreGuard&) = delete;
+        SemaphoreGuard& operator=(const SemaphoreGuard&) = delete;
+
+    private:
+        Semaphore* semaphore_;
+    };
+}
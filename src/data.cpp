@@ -121,7 +121,7 @@ namespace ensiie
 		return Smax_;
 	}
 
-	const std::vector<double>& Data::get_S() const
+	const ArenaVector<double>& Data::get_S() const
 	{
 		return S_;
 	}
@@ -1,4 +1,5 @@
 #pragma once
+#include "Arena.h"
 #include <vector>
 #include <stdexcept>
 #include <string>
@@ -54,7 +55,7 @@ namespace ensiie
 		double Smax_;
 
 		/** @brief Vector of discrete price nodes. */
-		std::vector<double> S_;
+		ArenaVector<double> S_;
 
 		/** @brief Build the discretized price grid. */
 		void discretize();
@@ -117,7 +118,7 @@ namespace ensiie
 		double get_Smax() const;
 
 		/** @brief Returns the vector of discretized price nodes. */
-		const std::vector<double>& get_S() const;
+		const ArenaVector<double>& get_S() const;
 
 		/** @brief Returns the option type. */
 		OptionType get_option_type() const;
@@ -1,15 +1,28 @@
 #include "Interface.h"
+#include "PricingServer.h"
+#include <string>
 #include <iostream>
 #include <stdexcept>
 
 
 int main(int argc, char* argv[]) {
     try {
+        // Server mode: one request per stdin line, newer requests pre-empt older ones
+        if (argc == 2 && std::string(argv[1]) == "serve") {
+            ensiie::PricingServer server(std::cout);
+            server.serve(std::cin);
+            return 0;
+        }
+
         // Initialize the interface with command line arguments from Excel
         ensiie::Interface app(argc, argv);
 
         // Execute the full calculation (Pricing + Graphs)
         app.run();
+
+        // Stopped by --deadline: stdout keeps the Excel format, the completion goes to stderr
+        if (app.is_partial())
+            std::cerr << "Partial: Paths;StdErr;Rows: " << app.partial_status() << std::endl;
     }
 
     catch (const std::invalid_argument& e) {
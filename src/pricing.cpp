@@ -7,54 +7,105 @@ namespace ensiie
     double Pricing::price() const
     {
         // discounted mean payoff
-        const double maturity = get_T() - get_t();
-        const double discount = std::exp(-get_r() * maturity);
-        return discount * payoff_mean();
+        return get_discount() * payoff_mean();
+    }
+
+    EstimatorState Pricing::estimator_state() const
+    {
+        EstimatorState state(optionType_, t_, T_, S0_, r_, sigma_, N_, seed_, settings_);
+        accumulate(state);
+        return state;
+    }
+
+    double Pricing::sum_over_paths(const ArenaVector<double>& values) const
+    {
+        throw_if_stop_requested();
+
+        // Block totals folded in block order: same arithmetic as EstimatorState
+        const ArenaVector<double> totals = block_totals(values.data(), static_cast<int>(values.size()));
+        return fold_blocks(static_cast<int>(totals.size()), [&](int b) { return totals[b]; });
     }
 
     double Pricing::payoff_mean() const
     {
-        const auto& paths = get_paths();
-        const int N = get_N();
+        const int N = get_path_count();
 
         if (N == 0)
             return 0.0;
 
-        double sum = 0.0;
-        for (int i = 0; i < N; ++i)
-        {
-            sum += payoff(paths[i]);
-        }
+        ArenaVector<double> values(N);
+        evaluate_payoffs(values.data());
 
-        return sum / static_cast<double>(N);
+        return sum_over_paths(values) / static_cast<double>(N);
     }
 
     double Pricing::payoff_std() const
     {
-        const int N = get_N();
+        const int N = get_path_count();
 
         if (N < 2)
             return 0.0; // std not defined for N < 2, return 0 for safety
 
-        const double mean = payoff_mean();
-        double accum = 0.0;
+        ArenaVector<double> values(N);
+        evaluate_payoffs(values.data());
+
+        throw_if_stop_requested();
+
+        // Centered block moments merged in block order: same arithmetic as EstimatorState
+        const ArenaVector<Moments> moments = block_moments(values.data(), N);
+        return std::sqrt(fold_moments(static_cast<int>(moments.size()), [&](int b) { return moments[b]; }).variance());
+    }
 
-        const auto& paths = get_paths();
+    double Pricing::payoff_stderr() const
+    {
+        const int N = get_path_count();
+        if (N == 0)
+            return 0.0;
+        return payoff_std() / std::sqrt(static_cast<double>(N));
+    }
+
+    void Pricing::apply_weights(double* out) const
+    {
+        const ArenaVector<double>& weights = get_weights();
+        for (size_t i = 0; i < weights.size(); ++i)
+            out[i] *= weights[i];
+    }
+
+    std::vector<Pricing::StratumStats> Pricing::stratum_statistics() const
+    {
+        const int N = get_path_count();
+        const int K = (settings_.sampling == Sampling::Stratified) ? settings_.strata : 1;
+
+        ArenaVector<double> values(N);
+        evaluate_payoffs(values.data());
+
+        // Welford update per stratum; path g of the run is in stratum g % K
+        std::vector<StratumStats> strata(K, StratumStats{ 0, 0.0, 0.0 });
         for (int i = 0; i < N; ++i)
         {
-            double p = payoff(paths[i]);
-            double diff = p - mean;
-            accum += diff * diff;
+            StratumStats& s = strata[(get_first_path() + i) % K];
+            s.count++;
+            const double d = values[i] - s.mean;
+            s.mean += d / s.count;
+            s.variance += d * (values[i] - s.mean);
         }
 
-        return std::sqrt(accum / static_cast<double>(N - 1)); // unbiased estimator
+        for (StratumStats& s : strata)
+            s.variance = (s.count < 2) ? 0.0 : s.variance / (s.count - 1);
+
+        return strata;
     }
 
-    double Pricing::payoff_stderr() const
+    double Pricing::stratified_stderr() const
     {
-        const int N = get_N();
+        const int N = get_path_count();
         if (N == 0)
             return 0.0;
-        return payoff_std() / std::sqrt(static_cast<double>(N));
+
+        double var = 0.0;
+        for (const StratumStats& s : stratum_statistics())
+            var += s.count * s.variance;
+
+        return std::sqrt(var) / static_cast<double>(N);
     }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MonteCarlo.h"
+#include "Estimator.h"
 
 namespace ensiie
 {
@@ -18,13 +19,17 @@ namespace ensiie
      * Child classes must implement:
      *   - payoff(path)
      *     where 'path' is a vector<double> containing the entire simulated trajectory.
+     *   - evaluate_payoffs(out)
+     *     which fills the payoffs of all paths in one call, so that the per-path
+     *     loop does not go through a virtual call (see LookbackPricing).
      */
     class Pricing : public MonteCarlo
     {
     public:
         Pricing(double t, double T, double S0, double r, double sigma,
-            int N, double dS, int M, const std::string& optionType, unsigned long seed)
-            : MonteCarlo(t, T, S0, r, sigma, N, dS, M, optionType,seed)
+            int N, double dS, int M, const std::string& optionType, unsigned long seed,
+            const SimulationSettings& settings = SimulationSettings())
+            : MonteCarlo(t, T, S0, r, sigma, N, dS, M, optionType, seed, settings)
         {
         }
 
@@ -36,7 +41,7 @@ namespace ensiie
         /// Computes the Monte Carlo price.
         double price() const;
 
-        double payoff_mean() const;              // mean payoff before discount
+        double payoff_mean() const;              // mean payoff before discount (over the stored paths)
         double payoff_std() const;               // std of payoff
         double payoff_stderr() const;            // std / sqrt(N)
 
@@ -46,5 +51,72 @@ namespace ensiie
         virtual double theta() const = 0;
         virtual double rho() const = 0;
 
+        /** @brief Second-order sensitivities of the price. */
+        struct SecondOrderGreeks
+        {
+            double gamma;   ///< d2 price / dS0^2
+            double vanna;   ///< d2 price / dS0 dsigma
+            double volga;   ///< d2 price / dsigma^2
+        };
+
+        /**
+         * @brief Gamma, Vanna and Volga from the stored paths, in one sweep.
+         *
+         * No bumped run is simulated: the estimators combine pathwise derivatives
+         * with likelihood-ratio weights of the same paths.
+         */
+        virtual SecondOrderGreeks second_order_greeks() const = 0;
+
+        /**
+         * @brief Mergeable partial sums of this run (or of its shard).
+         *
+         * Contains the BlockSums of the blocks simulated by this object, Theta and
+         * Rho bumps included; see EstimatorState.
+         */
+        EstimatorState estimator_state() const;
+
+        /**
+         * @brief Adds the BlockSums of the blocks simulated by this object to state.
+         *
+         * Lets a run be accumulated incrementally, batch of blocks after batch.
+         * Throws std::invalid_argument if state belongs to another run or
+         * already holds one of these blocks.
+         */
+        virtual void accumulate(EstimatorState& state) const = 0;
+
+        /** @brief Payoff statistics of one stratum of the terminal value. */
+        struct StratumStats
+        {
+            int count;        ///< Number of stored paths in the stratum
+            double mean;      ///< Mean (weighted) payoff, before discount
+            double variance;  ///< Unbiased variance of the payoff within the stratum
+        };
+
+        /**
+         * @brief Per-stratum payoff statistics of the stored paths.
+         *
+         * One entry per stratum with stratified sampling, a single entry otherwise.
+         */
+        std::vector<StratumStats> stratum_statistics() const;
+
+        /**
+         * @brief Standard error of the mean payoff from the within-stratum variances.
+         *
+         * With proportional allocation, Var = sum_j n_j sigma_j^2 / N^2: the
+         * between-strata variance removed by stratification does not count.
+         * Equal to payoff_stderr() (up to rounding) without stratification.
+         */
+        double stratified_stderr() const;
+
+    protected:
+        /// Sum of per-path values over the stored paths, block by block in block order.
+        /// Throws Cancelled if the request was stopped.
+        double sum_over_paths(const ArenaVector<double>& values) const;
+
+        /// Writes the payoff of each of the N paths into out[0..N-1].
+        virtual void evaluate_payoffs(double* out) const = 0;
+
+        /// Multiplies out[0..N-1] by the likelihood ratios of importance sampling, if any.
+        void apply_weights(double* out) const;
     };
 }